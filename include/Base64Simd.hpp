@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// ===================================================================
+// SIMD base64 encode/decode (caller-supplied buffer, no heap allocation)
+//  - x86: AVX2 / SSSE3 커널을 실행 시점에 CPU 기능을 보고 선택
+//  - aarch64: NEON 커널
+//  - 그 외: scalar fallback
+//  - base64.cpp와 같은 규칙: 표준('+/')과 URL('-_') 문자 모두 허용,
+//    padding('=' 또는 '.')은 생략 가능
+// ===================================================================
+enum class Base64Status : uint8_t {
+    OK = 0,
+    OUTPUT_TOO_SMALL,   // 출력 버퍼가 부족함
+    INVALID_LENGTH,     // 길이 % 4 == 1 등 완성될 수 없는 입력
+    INVALID_CHARACTER,  // base64 문자가 아닌 값, 잘못된 위치의 padding
+};
+
+// 인코딩 결과 길이 (padding 포함)
+inline size_t base64_encoded_size(size_t len) { return (len + 2) / 3 * 4; }
+
+// 디코딩 결과의 최대 길이 (실제 길이는 padding에 따라 1~2 바이트 작을 수 있음)
+inline size_t base64_decoded_max_size(size_t len) { return (len + 3) / 4 * 3; }
+
+// out에 base64 문자열을 씀 (NUL 종료 없음), out_len = 쓴 문자 수
+Base64Status base64_encode_to(const uint8_t* in, size_t len, char* out, size_t out_capacity, size_t& out_len);
+
+// out에 디코딩된 바이트를 씀, out_len = 쓴 바이트 수
+Base64Status base64_decode_to(const char* in, size_t len, uint8_t* out, size_t out_capacity, size_t& out_len);
+
+// 예외 없는 검증 + 디코딩 (256-entry table, 한 번의 pass)
+//  - 손상된 패킷도 정상 패킷과 같은 비용으로 처리
+//  - 실패 시 error_offset = 첫 번째 잘못된 문자의 위치 (입력 기준)
+struct Base64DecodeResult {
+    Base64Status status;
+    size_t written;         // 쓴 바이트 수 (실패 시 0)
+    size_t error_offset;    // INVALID_CHARACTER / INVALID_LENGTH 일 때만 의미 있음
+};
+
+Base64DecodeResult base64_decode_checked(const char* in, size_t len, uint8_t* out, size_t out_capacity);
+
+// 현재 선택된 커널 이름 ("avx2", "ssse3", "neon", "scalar")
+const char* base64_kernel_name();
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// Codec daemon protocol (fec_daemon <-> client, Unix domain socket SOCK_STREAM)
+//  - message: [type 1B][body length 4B big-endian][body]
+//  - 한 연결에서 job을 여러 번 보낼 수 있음 (연결을 유지하면 job마다 connect 비용도 없음)
+//  - ENCODE: [T 2B][min_blocks 2B][overhead % x 100 4B][flags 1B][원본 데이터]
+//      -> META(30-byte metadata record) + PACKET * n (블록 순서, source -> repair) + END([packets 4B])
+//  - DECODE: [flags 1B][metadata record 30B (OTI 필수)] 후 PACKET * n + END
+//      -> DATA(복원된 원본) + END([CODEC_HASH_* 1B]) / 심볼 부족, content hash 불일치면 ERROR
+//  - ERROR: 사람이 읽을 수 있는 메시지, 해당 job만 실패 (연결은 유지)
+//  - 모든 정수는 big-endian (TransferMeta와 같음)
+// ===================================================================
+enum class CodecMsg : uint8_t {
+    ENCODE = 1,
+    DECODE = 2,
+    PACKET = 3,
+    META = 4,
+    DATA = 5,
+    END = 6,
+    ERROR = 7,
+};
+
+const size_t CODEC_HEADER_SIZE = 5;
+const size_t CODEC_ENCODE_PARAMS_SIZE = 9;
+const uint32_t CODEC_MAX_MESSAGE = 64u << 20;   // 한 message 상한 (원본 / 복원 데이터 포함)
+const char* const DEFAULT_CODEC_SOCKET = "/tmp/fec_daemon.sock";
+
+// ENCODE flags
+const uint8_t CODEC_FLAG_COMPACT_ID = 0x01;     // --id compact
+const uint8_t CODEC_FLAG_CRC32C = 0x02;         // --check crc32c
+// DECODE flags
+const uint8_t CODEC_FLAG_FRAMED = 0x01;         // PACKET이 [n | Payload ID | n symbols] 프레임
+// DECODE END status
+const uint8_t CODEC_HASH_NONE = 0;              // record에 content hash 없음
+const uint8_t CODEC_HASH_VERIFIED = 1;
+
+struct EncodeParams {
+    uint16_t symbol_size = 32;
+    uint16_t min_blocks = 1;
+    double overhead_ratio = 10.0;   // %
+    uint8_t flags = 0;
+};
+
+void encode_params(const EncodeParams& params, uint8_t* out);      // out: CODEC_ENCODE_PARAMS_SIZE
+EncodeParams parse_encode_params(const uint8_t* in);
+
+// ===================================================================
+// Buffered message writer
+//  - PACKET처럼 작은 message를 모아서 write() 한 번으로 (패킷마다 syscall 없음)
+//  - flush()는 블록 / job 끝에서 -> 클라이언트는 블록 단위로 바로 받기 시작
+// ===================================================================
+class CodecWriter {
+public:
+    explicit CodecWriter(int fd, size_t flush_bytes = 64 * 1024) : _fd(fd), _flush_bytes(flush_bytes) {}
+
+    bool send(CodecMsg type, const uint8_t* body, size_t len);
+    bool send(CodecMsg type, const std::string& text) { return send(type, reinterpret_cast<const uint8_t*>(text.data()), text.size()); }
+    bool flush();
+
+private:
+    int _fd;
+    size_t _flush_bytes;
+    std::vector<uint8_t> _buffer;
+};
+
+// message 하나를 body까지 모두 읽음 (EOF / 오류 / 상한 초과면 false)
+bool read_codec_message(int fd, CodecMsg& type, std::vector<uint8_t>& body);
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// ===================================================================
+// CRC32C (Castagnoli, reflected poly 0x82F63B78)
+//  - x86: SSE4.2 crc32 명령 / aarch64: ARMv8 CRC32C 명령을 실행 시점에 선택
+//  - 그 외 / 미지원 CPU: slicing-by-8 table fallback
+//  - 패킷 무결성 검사용 (Base64가 통과시키는 bit 오류를 add_symbol 전에 걸러냄)
+// ===================================================================
+
+// crc = 이전 호출의 결과를 넘기면 이어서 계산 (처음은 0), crc32c("123456789") = 0xE3069283
+uint32_t crc32c(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+// 현재 선택된 커널 이름 ("sse4.2", "armv8", "table")
+const char* crc32c_kernel_name();
@@ -0,0 +1,154 @@
+#pragma once
+#include <RaptorQ/RaptorQ_v1_hdr.hpp>       // RaptorQ Library
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+// ===================================================================
+// FEC Payload ID (RFC 6330 3.2): [SBN 8 bit | ESI 24 bit], big-endian
+//  - SBN = 0 이면 기존 32-bit ID 패킷과 완전히 같은 바이트열이 됩니다.
+//    (단일 블록 파일은 예전 디코더로도 그대로 읽힘)
+// ===================================================================
+const size_t PAYLOAD_ID_SIZE = 4;
+const uint32_t MAX_SOURCE_BLOCKS = 256;
+const uint32_t MAX_ESI = 0x00FFFFFF;
+
+inline void write_payload_id(uint8_t* out, uint8_t sbn, uint32_t esi)
+{
+    out[0] = sbn;
+    out[1] = (esi >> 16) & 0xFF;
+    out[2] = (esi >> 8) & 0xFF;
+    out[3] = esi & 0xFF;
+}
+
+inline void read_payload_id(const uint8_t* in, uint8_t& sbn, uint32_t& esi)
+{
+    sbn = in[0];
+    esi = (static_cast<uint32_t>(in[1]) << 16) |
+          (static_cast<uint32_t>(in[2]) << 8)  |
+          (static_cast<uint32_t>(in[3]));
+}
+
+// ===================================================================
+// Compact Payload ID (unframed 패킷 전용): 4 bytes 대신 1~3 bytes
+//  - value = (ESI << sbn_bits) | SBN, sbn_bits = ceil(log2(Z)) (Z = 1이면 0 bit)
+//  - LEB128 varint (7 bit씩, 상위 bit = 다음 byte 있음): value < 128 -> 1 byte, < 16384 -> 2 bytes
+//    (K=26 + repair 3, Z=1 이면 모든 패킷이 1 byte)
+//  - 디코더는 T를 알고 있으므로 ID 길이 = 패킷 길이 - T
+//    · 4 -> 기존 [SBN | ESI] 4 bytes, 1~3 -> compact (4 bytes varint는 쓰지 않음 -> 구분 가능)
+//  - 3 bytes(21 bit)에 안 들어가는 패킷은 기존 4-byte ID로 보냄 (섞여 있어도 됨)
+// ===================================================================
+const size_t COMPACT_ID_MAX_SIZE = 3;
+
+// Z개의 블록을 구분하는 데 필요한 bit 수
+uint8_t sbn_bits_for(size_t num_blocks);
+
+// compact ID를 기록하고 길이(1~3)를 반환, 3 bytes에 안 들어가면 0 (아무것도 쓰지 않음)
+size_t write_compact_id(uint8_t* out, uint8_t sbn, uint32_t esi, uint8_t sbn_bits);
+
+// 패킷 길이로 ID 형식을 판별해 SBN / ESI를 읽음 (compact: varint가 정확히 len - T 에서 끝나야 함)
+//  - 성공하면 ID 길이(1~4), 길이 / varint 형식이 맞지 않으면 0
+size_t read_any_payload_id(const uint8_t* packet, size_t len, uint16_t symbol_size, uint8_t sbn_bits,
+                           uint8_t& sbn, uint32_t& esi);
+
+// [4B ID | symbol] 패킷을 compact ID 패킷으로 변환 (out은 PAYLOAD_ID_SIZE + T 이상), 결과 길이 반환
+//  - compact로 표현할 수 없으면 원래 패킷을 그대로 복사
+size_t compact_packet(const uint8_t* packet, uint16_t symbol_size, uint8_t sbn_bits, uint8_t* out);
+
+// ===================================================================
+// Packet CRC32C trailer (선택): [Payload ID | symbol | CRC32C 4B little-endian]
+//  - CRC는 ID + symbol 전체에 대해 계산 (Crc32c.hpp: SSE4.2 / ARMv8 명령, table fallback)
+//  - 디코더는 len - T 로 판별: 1~4 -> trailer 없음, 5~8 -> ID 1~4 bytes + CRC
+//  - 검사에 실패한 패킷은 add_symbol 전에 버림 (손실과 같은 erasure)
+//  - 프레임(--mtu)에는 붙이지 않음 (n * T 로 T를 추정하므로 길이로 구분할 수 없음)
+// ===================================================================
+const size_t PACKET_CRC_SIZE = 4;
+
+enum class PacketCheck {
+    NONE,   // trailer 없음
+    OK,     // CRC 일치 (len에서 trailer 제외)
+    BAD,    // CRC 불일치 -> 버려야 함
+};
+
+// packet[0, len) 뒤에 CRC를 붙이고 새 길이 반환 (packet은 len + PACKET_CRC_SIZE 이상)
+size_t append_packet_crc(uint8_t* packet, size_t len);
+
+// trailer가 있으면 검사하고 OK일 때 len을 trailer 앞까지로 줄임
+PacketCheck check_packet_crc(const uint8_t* packet, size_t& len, uint16_t symbol_size);
+
+// 인코더 출력 형식 (--id full|compact, --check none|crc32c)
+struct PacketFormat {
+    bool compact_id = false;
+    uint8_t sbn_bits = 0;       // compact_id일 때 sbn_bits_for(Z)
+    bool crc = false;
+};
+
+inline size_t packet_buffer_size(uint16_t symbol_size) { return PAYLOAD_ID_SIZE + symbol_size + PACKET_CRC_SIZE; }
+
+// [4B ID | symbol] 패킷을 format대로 out에 기록하고 길이 반환 (out은 packet_buffer_size(T) 이상)
+size_t format_packet(const uint8_t* packet, uint16_t symbol_size, const PacketFormat& format, uint8_t* out);
+
+// ceil(K * overhead_ratio / 100)
+//  - overhead_ratio = 100 * r / K 처럼 repair 수에서 거꾸로 계산한 값도 정확히 r이 되도록
+//    부동소수점 오차(1e-9)는 무시
+inline uint32_t repair_symbol_count(uint32_t num_source_symbols, double overhead_ratio)
+{
+    double r = num_source_symbols * (overhead_ratio / 100.0) - 1e-9;
+    return r > 0 ? static_cast<uint32_t>(std::ceil(r)) : 0;
+}
+
+// 원본 데이터 중 하나의 source block이 차지하는 구간
+struct SourceBlock {
+    uint8_t sbn;
+    size_t offset;                  // 원본 데이터에서의 시작 위치 (bytes)
+    size_t length;                  // 이 블록에 속한 실제 데이터 길이 (bytes)
+    uint32_t min_symbols;           // ceil(length / symbol_size)
+    RaptorQ__v1::Block_Size block;  // 실제 K (>= min_symbols 인 가장 작은 Block_Size)
+};
+
+// min_symbols 이상인 가장 작은 Block_Size (없으면 가장 큰 Block_Size)
+RaptorQ__v1::Block_Size select_block_size(uint32_t min_symbols);
+
+// 가장 큰 Block_Size의 심볼 수 (한 블록에 담을 수 있는 최대 K)
+uint32_t max_block_symbols();
+
+// RFC 6330 4.4.1.2 방식으로 원본을 Z개의 source block으로 나눕니다.
+//  - Z = max(min_blocks, ceil(Kt / max_block_symbols()))
+//  - 파일이 한 블록에 들어가고 min_blocks == 1 이면 기존과 같은 단일 블록
+//  - Z > 256 이 되면 빈 vector를 반환
+std::vector<SourceBlock> partition_source_blocks(size_t transfer_length, uint16_t symbol_size,
+                                                 uint32_t min_blocks = 1);
+
+// 한 블록의 인코딩 결과: [Payload ID 4B | symbol] 패킷이 연속으로 저장된 버퍼
+struct EncodedBlock {
+    uint8_t sbn = 0;
+    uint32_t num_source_symbols = 0;
+    uint32_t num_packets = 0;
+    bool ok = false;
+    std::vector<uint8_t> packets;   // num_packets * (PAYLOAD_ID_SIZE + symbol_size)
+};
+
+// [0, count)를 구간으로 나눠 num_threads개의 thread(호출한 thread 포함)에서 fn(begin, end) 실행
+//  - 구간 크기 >= min_chunk, 다음 구간은 atomic counter로 가져감 (구간이 하나면 thread를 만들지 않음)
+//  - fn이 index 자리에만 쓰면 결과는 thread 수 / 실행 순서와 무관
+//  - num_threads == 0 이면 hardware_concurrency() 사용
+void parallel_for_ranges(size_t count, size_t min_chunk, unsigned num_threads,
+                         const std::function<void(size_t begin, size_t end)>& fn);
+
+// repair 생성을 thread에 나눌 때 한 구간의 최소 심볼 수 (K=26 + repair 3 같은 작은 블록은 thread 없이)
+const uint32_t REPAIR_CHUNK_MIN_SYMBOLS = 64;
+
+class MatrixCache;
+
+// 각 source block을 별도의 worker thread에서 compute_sync() 후 인코딩합니다.
+//  - num_threads == 0 이면 hardware_concurrency() 사용
+//  - 블록마다 ceil(K * overhead_ratio / 100) 개의 repair symbol 생성
+//  - repair symbol은 compute_sync 후 모든 블록의 ESI 구간을 thread들이 나눠 결과 버퍼의 제자리에 기록
+//    (블록이 1개여도 repair가 많으면 모든 코어 사용, 패킷 순서는 블록 -> ESI 그대로)
+//  - cache가 있으면 K별 repair 계수(MatrixCache.hpp)로 compute_sync 생략 (처음 보는 K는 추출 후 저장)
+std::vector<EncodedBlock> encode_blocks_parallel(std::vector<uint8_t>& source_data,
+                                                 const std::vector<SourceBlock>& blocks,
+                                                 uint16_t symbol_size, double overhead_ratio,
+                                                 unsigned num_threads = 0, MatrixCache* cache = nullptr);
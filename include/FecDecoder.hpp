@@ -0,0 +1,181 @@
+#pragma once
+#include "FecBlocks.hpp"
+#include "TransferMeta.hpp"
+#include "XxHash64.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// Multi-block RaptorQ decoder (수신 경로용)
+//  - 파일 디코더(FEC_image_decode)와 같은 source block 분할 / SBN별 Decoder
+//  - 패킷([Payload ID(4B 또는 compact 1~3B) | symbol | (CRC32C)]), 프레임([n | Payload ID | n symbols]),
+//    심볼 단위로 바로 add_symbol() -> 중간 파일 없음
+//  - Systematic fast path: ESI < K 인 source symbol은 도착하는 즉시 출력 버퍼의
+//    제자리에 복사하고 bitmap에 표시. 블록의 source symbol이 모두 모이면
+//    end_of_input / wait_sync / decode_bytes 없이 완료 (repair가 필요할 때만 행렬 디코딩)
+//  - Progressive output: source symbol은 이미 최종 평문이므로 OutputSink로 바로 내보내고,
+//    행렬 디코딩은 빠진 구간(hole)만 다시 내보냄
+//  - Content hash: 앞에서부터 확정되는 구간을 순서대로 xxHash64에 넣고 (별도 pass 없음),
+//    metadata record의 hash와 다르면 행렬 디코딩한 블록을 다시 열어 심볼을 더 받음
+//  - OTI: metadata record(version 2)만으로 F / T / Z를 알 수 있음 -> FecDecoder(meta)
+// ===================================================================
+// 출력에서 유효한(최종 값이 확정된) 바이트 구간 [offset, offset + length)
+struct ByteRange {
+    uint64_t offset;
+    uint64_t length;
+};
+
+// "[0, 320) [384, 1018)" 형태 (max_ranges개 이후는 "... (N more)")
+std::string format_ranges(const std::vector<ByteRange>& ranges, size_t max_ranges = 8);
+
+class FecDecoder {
+public:
+    using InputIt = const uint8_t*;
+    using OutputIt = std::vector<uint8_t>::iterator;
+    using Decoder = RaptorQ__v1::Decoder<InputIt, OutputIt>;
+
+    // 확정된 바이트가 생길 때마다 호출 (offset은 원본 기준, data는 data() 안을 가리킴)
+    using OutputSink = std::function<void(uint64_t offset, const uint8_t* data, size_t len)>;
+
+    enum class AddResult {
+        ADDED,          // decoder에 추가됨
+        NOT_NEEDED,     // 이미 ready인 블록 / 중복 심볼
+        UNKNOWN_BLOCK,  // SBN >= Z
+        BAD_SIZE,       // 패킷/프레임 길이가 T와 맞지 않음
+        BAD_CHECKSUM,   // CRC32C trailer 불일치 (erasure로 처리)
+        METADATA,       // transfer metadata record (content hash 등록, 다른 전송의 record면 무시)
+        ERROR,          // add_symbol() 오류
+    };
+
+    // transfer_length / symbol_size / min_blocks는 인코더와 같아야 함
+    FecDecoder(uint64_t transfer_length, uint16_t symbol_size, uint32_t min_blocks = 1);
+    // metadata record의 OTI로 생성 (분할 결과의 Z / K가 record와 다르면 valid() == false)
+    //  - record에 hash가 있으면 setExpectedHash()까지
+    explicit FecDecoder(const TransferMeta& meta);
+
+    // 분할이 불가능한 경우(Z > 256) false
+    bool valid() const { return !_blocks.empty(); }
+
+    // 이후 도착하는 source symbol / 복원된 hole을 sink로 내보냄 (addSymbol 전에 설정)
+    void setOutputSink(OutputSink sink) { _sink = std::move(sink); }
+
+    AddResult addSymbol(uint8_t sbn, uint32_t esi, const uint8_t* payload);
+    AddResult addPacket(const uint8_t* packet, size_t len);
+    // 프레임 안의 심볼을 모두 추가, 하나라도 ADDED면 ADDED
+    AddResult addFrame(const uint8_t* frame, size_t len);
+
+    enum class HashStatus {
+        UNKNOWN,        // metadata record를 아직 받지 못함
+        PENDING,        // 아직 확정되지 않은 구간이 있음
+        MATCH,
+        MISMATCH,       // 복원 결과가 원본과 다름 -> reopenBlocks()
+    };
+    // metadata record 없이 hash를 알고 있는 경우 (컨테이너 헤더 등)
+    void setExpectedHash(uint64_t hash);
+    HashStatus hashStatus() const;
+    uint64_t contentHash() const { return _hasher.digest(); }
+    // hash 불일치 시: 행렬 디코딩한 블록(모두 source symbol로 완료됐으면 전체)을 새 Decoder로 되돌림
+    //  - 해당 블록은 다시 ready가 될 때까지 심볼을 받아야 함 (symbolsNeeded() > 0), 되돌린 블록 수 반환
+    size_t reopenBlocks();
+    uint32_t hashMismatches() const { return _hash_mismatches; }
+
+    bool ready() const { return _blocks_ready == _decoders.size(); }
+
+    // 아직 복원하지 않은 블록을 모두 복원 (ready()일 때만), 결과는 data()
+    //  - rank가 부족한 블록이 있으면 false이고 ready()도 false -> 심볼을 더 받은 뒤 다시 호출
+    bool decode();
+    // ready가 됐지만 아직 복원하지 않은 블록만 wait_sync() 후 data()에 복원
+    //  - 나머지 블록을 수신하는 동안 먼저 끝난 블록을 처리할 때 사용
+    //  - wait_sync()가 NEED_DATA(받은 심볼로 rank 부족)인 블록은 받은 심볼을 유지한 채 다시 열어
+    //    심볼 하나를 더 받으면 다시 ready (symbolsNeeded() > 0 -> 다음 NEED에 포함)
+    //  - 그 밖의 오류로 실패한 블록이 있으면 false
+    bool decodeReadyBlocks();
+    // rank 부족으로 다시 연 횟수
+    uint32_t rankDeficits() const { return _rank_deficits; }
+    bool decoded() const { return _blocks_decoded == _decoders.size(); }
+    // 복원된 데이터 (transfer_length 바이트), decoded() 전에는 일부만 채워져 있음
+    const std::vector<uint8_t>& data() const { return _data; }
+    // data()에서 이미 확정된 구간 (인접 구간은 합쳐서, offset 순)
+    std::vector<ByteRange> validRanges() const;
+    uint64_t validBytes() const { return _valid_bytes; }
+
+    uint64_t transferLength() const { return _transfer_length; }
+    // OTI record에서 받은 transfer ID (hasTransferId()가 false면 아직 모름)
+    bool hasTransferId() const { return _has_transfer_id; }
+    uint32_t transferId() const { return _transfer_id; }
+    uint16_t symbolSize() const { return _symbol_size; }
+    const std::vector<SourceBlock>& blocks() const { return _blocks; }
+    size_t blocksReady() const { return _blocks_ready; }
+    // source symbol만으로 완료된 블록 수 (행렬 디코딩 생략)
+    size_t fastPathBlocks() const { return _fast_path_blocks; }
+    uint32_t received() const { return _received; }
+    // CRC 검사에 실패해 버린 패킷 수 (symbolsArrived()에는 포함되지 않음 -> 손실로 보고)
+    uint32_t checksumFailures() const { return _checksum_failures; }
+    // 이 블록이 ready가 되려면 더 필요한 심볼 수의 추정치 (K - 받은 심볼, ready면 0)
+    //  - rateless 송신 측에 "need N more" feedback으로 보냄
+    uint32_t symbolsNeeded(uint8_t sbn) const;
+    // 손실률 report: 도착한 심볼 수 (중복/불필요 포함) / 블록별 (최대 ESI + 1)의 합
+    //  - 송신 측이 블록마다 ESI 순서대로 보낸다고 가정 (source -> repair)
+    uint32_t symbolsArrived() const { return _arrived; }
+    uint32_t symbolsExpected() const;
+    uint32_t sourceSymbols() const { return _source_symbols; }
+
+private:
+    struct BlockState {
+        size_t bitmap_base = 0;     // _bitmap 안에서 이 블록의 첫 bit
+        uint32_t present = 0;       // 도착한 source symbol 수 (ESI < min_symbols)
+        uint32_t received = 0;      // 이 블록에 추가된 심볼 수 (source + repair)
+        uint32_t esi_end = 0;       // 지금까지 본 최대 ESI + 1
+        bool ready = false;         // decoder.ready() 또는 source symbol 완비
+        bool decoded = false;       // _data에 복원 완료
+        bool fast_path = false;     // source symbol만으로 완료
+        uint32_t retry_at = 0;      // rank 부족으로 다시 연 블록: received가 이 값이 되어야 다시 ready
+        // decoder에 넣은 ESI >= min_symbols 심볼 (rank 부족 시 새 Decoder에 다시 넣음, source는 _data에 있음)
+        std::vector<uint32_t> extra_esi;
+        std::vector<uint8_t> extra_symbols;
+    };
+
+    bool testAndSet(size_t bit);
+    bool testBit(size_t bit) const { return (_bitmap[bit >> 6] >> (bit & 63)) & 1; }
+    // 블록 안에서 bitmap 값이 present인 심볼 구간마다 fn(offset, len) (ESI가 연속이면 한 번에)
+    template <typename Fn> void forEachRun(size_t b, bool present, Fn fn) const;
+    // wait_sync() NEED_DATA: 새 Decoder에 받은 심볼을 다시 넣고 ready를 해제
+    void rearmBlock(size_t b);
+    // 앞에서부터 연속으로 확정된 구간까지 hash 진행
+    void advanceHash();
+    // record가 이 전송(F / T / Z / K / transfer ID)을 설명하는지
+    bool matchesTransfer(const TransferMeta& meta) const;
+
+    uint64_t _transfer_length;
+    uint16_t _symbol_size;
+    uint8_t _sbn_bits = 0;          // compact Payload ID의 SBN bit 수
+    std::vector<SourceBlock> _blocks;
+    std::vector<std::unique_ptr<Decoder>> _decoders;
+    std::vector<BlockState> _state;
+    std::vector<uint64_t> _bitmap;
+    std::vector<uint8_t> _data;
+    OutputSink _sink;
+    uint64_t _valid_bytes = 0;
+    size_t _blocks_ready = 0;
+    size_t _blocks_decoded = 0;
+    size_t _fast_path_blocks = 0;
+    uint32_t _received = 0;
+    uint32_t _source_symbols = 0;
+    uint32_t _arrived = 0;
+    uint32_t _checksum_failures = 0;
+    uint32_t _rank_deficits = 0;
+    bool _has_transfer_id = false;
+    uint32_t _transfer_id = 0;
+
+    XxHash64 _hasher;
+    std::vector<XxHash64> _hash_marks;  // 블록 시작 시점의 hash 상태 (reopen 시 되돌림)
+    uint64_t _hash_cursor = 0;          // [0, _hash_cursor) 까지 hash에 반영됨
+    size_t _hash_block = 0;
+    bool _has_expected_hash = false;
+    uint64_t _expected_hash = 0;
+    uint32_t _hash_mismatches = 0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// ===================================================================
+// Receiver -> transmitter feedback (rateless send-until-done)
+//  - Frame: [magic 0xFB][type 1B][count 1B][SBN 1B | more 2B (big-endian)] * count
+//           [received 4B][expected 4B]  (손실률 report, 없는 프레임도 허용)
+//    · DONE: 모든 블록 복원 완료, count = 0
+//    · NEED: 아직 ready가 아닌 블록마다 "repair symbol이 more개 더 필요"
+//    · received / expected: 수신 측이 받은 심볼 수 / ESI로 본 송신 심볼 수 (LossEstimator 입력)
+//  - 데이터 패킷처럼 Base64로 AT+SEND (AT+SEND 240자 = 180 bytes 안에 들어가야 함)
+//    · 블록 1개인 NEED = 3 + 3 + 8 = 14 bytes -> 20 chars
+//    · 블록 56개인 NEED = 3 + 168 + 8 = 179 bytes -> 240 chars (더 많으면 모듈이 +ERR)
+// ===================================================================
+const uint8_t FEEDBACK_MAGIC = 0xFB;
+const size_t FEEDBACK_MAX_TEXT = 240;                           // AT+SEND 최대 payload (DEFAULT_LORA_MTU)
+const size_t FEEDBACK_MAX_BYTES = FEEDBACK_MAX_TEXT / 4 * 3;    // Base64 디코딩 후 180 bytes
+const size_t FEEDBACK_HEADER_SIZE = 3;
+const size_t FEEDBACK_REPORT_SIZE = 8;
+// NEED 한 프레임에 담는 최대 블록 수 ((180 - 11) / 3 = 56), 더 많은 미완료 블록은 다음 NEED에서
+const size_t FEEDBACK_MAX_BLOCKS = (FEEDBACK_MAX_BYTES - FEEDBACK_HEADER_SIZE - FEEDBACK_REPORT_SIZE) / 3;
+static_assert(FEEDBACK_MAX_BLOCKS == 56, "NEED frame must fit in one AT+SEND");
+static_assert(FEEDBACK_HEADER_SIZE + 3 * FEEDBACK_MAX_BLOCKS + FEEDBACK_REPORT_SIZE <= FEEDBACK_MAX_BYTES,
+              "NEED frame must fit in one AT+SEND");
+
+enum class FeedbackType : uint8_t { DONE = 1, NEED = 2 };
+
+struct BlockNeed {
+    uint8_t sbn;
+    uint16_t more;
+};
+
+struct Feedback {
+    FeedbackType type = FeedbackType::DONE;
+    std::vector<BlockNeed> needs;
+    uint32_t received = 0;
+    uint32_t expected = 0;      // 0: report 없음
+};
+
+// 최대 3 + 3 * FEEDBACK_MAX_BLOCKS + 8 bytes (더 많은 블록은 잘림)
+std::vector<uint8_t> encode_feedback(const Feedback& fb);
+// magic / 길이가 맞지 않으면 false (데이터 패킷과 구분)
+bool parse_feedback(const uint8_t* data, size_t len, Feedback& out);
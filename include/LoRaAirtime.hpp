@@ -0,0 +1,52 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ===================================================================
+// LoRa time-on-air (Semtech AN1200.13) + UART 전송 시간
+//  - 시뮬레이터(lora_sim)와 throughput 계산에서 같은 모델을 사용
+// ===================================================================
+struct LoRaParams {
+    unsigned spreading_factor = 9;      // SF 7~12
+    uint32_t bandwidth_hz = 125000;     // 125k / 250k / 500k
+    unsigned coding_rate = 1;           // 1~4 -> 4/5 ~ 4/8
+    unsigned preamble = 12;             // RYLR 기본값
+    bool explicit_header = true;
+    bool crc = true;
+};
+
+// RYLR 모듈이 지원하는 대역폭인지 (그 외 값은 airtime이 무한대 / 의미 없는 값이 됨)
+inline bool lora_bandwidth_valid(uint32_t bandwidth_hz)
+{
+    return bandwidth_hz == 125000 || bandwidth_hz == 250000 || bandwidth_hz == 500000;
+}
+
+// 심볼 하나의 시간 (ms)
+inline double lora_symbol_ms(const LoRaParams& p)
+{
+    return std::ldexp(1.0, static_cast<int>(p.spreading_factor)) * 1000.0 / p.bandwidth_hz;
+}
+
+// payload_len 바이트 패킷 하나의 airtime (ms)
+inline double lora_airtime_ms(const LoRaParams& p, size_t payload_len)
+{
+    const double t_sym = lora_symbol_ms(p);
+    const int sf = static_cast<int>(p.spreading_factor);
+    const int de = t_sym > 16.0 ? 1 : 0;    // low data rate optimize
+    const int ih = p.explicit_header ? 0 : 1;
+    const int crc = p.crc ? 1 : 0;
+
+    const double t_preamble = (p.preamble + 4.25) * t_sym;
+    const double num = 8.0 * payload_len - 4.0 * sf + 28 + 16 * crc - 20 * ih;
+    const double den = 4.0 * (sf - 2 * de);
+    const double payload_symbols = 8 + std::max(std::ceil(num / den) * (p.coding_rate + 4), 0.0);
+    return t_preamble + payload_symbols * t_sym;
+}
+
+// 8N1 UART로 bytes 바이트를 보내는 시간 (ms)
+inline double uart_delay_ms(size_t bytes, uint32_t baud_rate)
+{
+    return baud_rate == 0 ? 0.0 : bytes * 10.0 * 1000.0 / baud_rate;
+}
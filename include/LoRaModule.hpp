@@ -1,13 +1,56 @@
 #pragma once
 #include "SerialPort.hpp"
+#include <deque>
 #include <string>
 
+// AT 명령 최종 응답
+enum class AtResult { NONE, OK, ERR, TIMEOUT };
+
+// 수신 frame: +RCV=<address>,<length>,<data>,<RSSI>,<SNR>
+struct LoRaFrame {
+    int address = 0;
+    std::string data;
+    int rssi = 0;
+    int snr = 0;
+};
+
+// "\r\n"을 뗀 +RCV= 한 줄을 파싱 (data는 length 만큼 잘라냄 -> data 안의 ','도 허용)
+//  - line 바로 뒤에 숫자가 아닌 문자('\r' / '\n')가 있어야 함 (SerialPort::readLine 결과)
+bool parse_rcv_line(const char* line, size_t len, LoRaFrame& out);
+
+// SerialPort::readLine()이 꺼낸 줄을 +OK / +ERR=N / +RCV= 로 분류
+//  - +RCV= 줄은 frame queue에 쌓고, +READY 같은 그 외 줄은 무시
+class AtResponseParser {
+public:
+    void reset() { _error_code = 0; }
+    // 최종 응답(+OK / +ERR=N)이면 OK / ERR, 그 외는 NONE
+    AtResult parseLine(const char* line, size_t len);
+    int errorCode() const { return _error_code; }
+    // 지금까지 파싱된 +RCV frame 하나를 꺼냄
+    bool popFrame(LoRaFrame& out);
+private:
+    int _error_code = 0;
+    std::deque<LoRaFrame> _frames;
+};
+
 class LoRaModule {
 public:
     LoRaModule(const std::string& port_name, speed_t baud_rate);
     bool checkConnection();
     bool sendData(const std::string& data, int address);
+    // 수신 모드: +RCV frame 하나가 올 때까지 대기 (timeout_ms 안에 없으면 false)
+    //  - sendData()가 +OK를 기다리는 동안 받은 +RCV도 여기서 꺼냄 (timeout_ms = 0: 이미 도착한 줄만 읽고 기다리지 않음)
+    bool receive(LoRaFrame& out, int timeout_ms);
+    // AT+SEND 응답 deadline (ms), 응답이 오면 즉시 반환하므로 상한값일 뿐
+    void setResponseTimeout(int timeout_ms) { _response_timeout_ms = timeout_ms; }
+    // 마지막 +ERR=N 의 N (없으면 0)
+    int lastError() const { return _parser.errorCode(); }
 private:
     SerialPort _port;
+    AtResponseParser _parser;
+    int _response_timeout_ms = 1000;
+    bool sendCommand(const std::string& command);
+    bool sendParts(const struct iovec* iov, int count, size_t total);
+    AtResult waitForResponse(int timeout_ms);
     bool waitForOk();
 };
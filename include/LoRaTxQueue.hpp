@@ -0,0 +1,58 @@
+#pragma once
+#include "LoRaModule.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// ===================================================================
+// Asynchronous LoRa transmit queue
+//  - 전용 thread가 bounded queue의 패킷을 LoRaModule로 내보냄
+//  - payload는 push() 시점에 queue로 move, worker는 +OK를 받는 즉시
+//    다음 payload를 writev로 보냄 (AT+SEND= prefix / payload / CRLF를 이어 붙이지 않음)
+//  - queue가 가득 차면 push()가 대기 (backpressure)
+//  - 전송 실패한 패킷은 재전송하지 않고 failed로만 셈 (FEC가 손실을 복구)
+// ===================================================================
+class LoRaTxQueue {
+public:
+    struct Stats {
+        uint64_t sent = 0;              // +OK 받은 패킷
+        uint64_t failed = 0;            // +ERR / timeout
+        size_t depth = 0;               // 현재 queue 길이
+        size_t max_depth = 0;           // 최대 queue 길이
+        double packets_per_sec = 0.0;   // 첫 전송부터 지금까지 평균
+    };
+
+    LoRaTxQueue(LoRaModule& module, int address, size_t capacity = 64);
+    ~LoRaTxQueue();
+    LoRaTxQueue(const LoRaTxQueue&) = delete;
+    LoRaTxQueue& operator=(const LoRaTxQueue&) = delete;
+
+    // payload(Base64 문자열 등) 하나를 추가, queue가 가득 차면 자리가 날 때까지 대기
+    // close() 이후에는 false
+    bool push(std::string payload);
+    // 더 이상 push하지 않음, 남은 패킷을 모두 보낸 뒤 thread 종료까지 대기
+    void close();
+    Stats stats() const;
+
+private:
+    void run();
+
+    LoRaModule& _module;
+    const int _address;
+    const size_t _capacity;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _not_empty;
+    std::condition_variable _not_full;
+    std::deque<std::string> _queue;     // 보낼 payload
+    bool _closed = false;
+
+    Stats _stats;
+    bool _started = false;
+    std::chrono::steady_clock::time_point _start_time;
+    std::thread _worker;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "FecBlocks.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// Adaptive overhead: 목적지 주소별 손실률 추정 + repair 수 선택
+//  - 수신 측 report(받은 심볼 / 보낸 심볼)로 EWMA 갱신, 텍스트 파일에 저장
+//    (링크 손실률은 몇 시간 단위로 천천히 변하므로 전송 사이에 유지)
+//  - repair 수는 목표 디코딩 성공 확률로 선택 (고정 overhead_ratio = 10% 대신)
+//    · 받은 심볼 수 ~ Binomial(K + r, 1 - loss)
+//    · K + h개를 받았을 때 RaptorQ 디코딩 실패 확률 ≈ 0.01^(h + 1)
+//  - 전송 성공 = Z개 블록이 모두 디코딩 -> 블록마다 target^(1/Z)를 목표로 repair 선택
+// ===================================================================
+const char DEFAULT_LOSS_ESTIMATE_FILE[] = "../data/loss_estimate.txt";
+const double DEFAULT_OVERHEAD_RATIO = 10.0;     // 추정치가 없는 주소에 쓰는 기존 값 (%)
+const double DEFAULT_TARGET_SUCCESS = 0.999;
+
+struct LinkEstimate {
+    double loss = 0.0;          // EWMA 손실률 (0..1)
+    uint32_t reports = 0;       // 반영된 report 수
+    uint32_t transfers = 0;     // 결과를 아는 전송 수
+    uint32_t successes = 0;     // 그중 수신 측이 DONE을 보낸 전송
+};
+
+class LossEstimator {
+public:
+    explicit LossEstimator(double alpha = 0.25) : _alpha(alpha) {}
+
+    // 파일이 없으면 빈 상태로 true (첫 실행)
+    bool load(const std::string& path = DEFAULT_LOSS_ESTIMATE_FILE);
+    bool save(const std::string& path = DEFAULT_LOSS_ESTIMATE_FILE) const;
+
+    // 수신 측 report 반영 (expected: 수신 측이 본 ESI 기준 송신 수), 갱신된 손실률 반환
+    double update(int address, uint32_t received, uint32_t expected);
+    // 전송 결과 (관찰된 성공률 = successes / transfers)
+    void recordOutcome(int address, bool success);
+
+    bool has(int address) const { return _links.count(address) && _links.at(address).reports > 0; }
+    LinkEstimate get(int address) const;
+
+private:
+    double _alpha;
+    std::map<int, LinkEstimate> _links;
+};
+
+// K개 source + repair개를 손실률 loss 채널로 보냈을 때 디코딩 성공 확률
+double decode_success_probability(uint32_t k, uint32_t repair, double loss);
+
+struct OverheadChoice {
+    bool estimated = false;     // false: 추정치 없음 -> DEFAULT_OVERHEAD_RATIO
+    double loss = 0.0;
+    uint32_t repair = 0;        // K 기준 repair 수
+    double overhead_ratio = DEFAULT_OVERHEAD_RATIO;    // 100 * repair / K (인코더에 그대로 넘김)
+    double success = 0.0;       // 예상 성공 확률 (estimated일 때만, choose_transfer_overhead는 전송 전체)
+    size_t num_blocks = 1;
+};
+
+// 목표 성공 확률 이상이 되는 최소 repair 수 (max_overhead_ratio %까지)
+OverheadChoice choose_overhead(const LossEstimator& estimator, int address, uint32_t k,
+                               double target = DEFAULT_TARGET_SUCCESS, double max_overhead_ratio = 300.0);
+
+// 전송 전체(Z개 블록)가 target 이상으로 성공하는 overhead_ratio
+//  - 블록마다 target^(1/Z)를 만족하는 repair 수를 구하고, 모든 블록에 같은 ratio를 쓰므로 그중 가장 큰
+//    100 * repair / K 를 선택 (KL / KS 블록의 ceil(K * ratio / 100)이 각자의 목표 이상)
+//  - success = 실제로 적용될 블록별 repair 수로 계산한 모든 블록의 성공 확률 곱
+OverheadChoice choose_transfer_overhead(const LossEstimator& estimator, int address, const std::vector<SourceBlock>& blocks,
+                                        double target = DEFAULT_TARGET_SUCCESS, double max_overhead_ratio = 300.0);
+
+// 인코더용: 추정치 파일을 읽고 source block 분할 전체에 대해 overhead_ratio(%) 선택
+//  - verbose면 선택한 overhead, 손실률, 예상(전송 전체)/관찰 성공률을 출력
+double adaptive_overhead_ratio(const std::string& estimator_path, int address, const std::vector<SourceBlock>& blocks,
+                               double target, bool verbose);
+double adaptive_overhead_ratio(const std::string& estimator_path, int address, size_t transfer_length,
+                               uint16_t symbol_size, uint32_t min_blocks, double target, bool verbose);
@@ -0,0 +1,86 @@
+#pragma once
+#include "FecBlocks.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// Persistent repair-coefficient cache (K별, memory-mapped 파일)
+//  - RaptorQ 인코딩은 GF(256) 위의 선형 변환이고 심볼의 byte 위치마다 같은 계수로 독립
+//    -> repair symbol (ESI = K + r) = sum_i G[r][i] * source_i   (G: rows x K, T와 무관)
+//  - G 추출: T = K bytes, source i = 단위 벡터 e_i 로 compute_sync 한 번 -> repair r의 byte p = G[r][p]
+//  - 이후 같은 K의 블록은 compute_sync(제약 행렬 분해) 없이 G로 repair 생성 (행렬 곱만)
+//  - 파일: <dir>/k<K>.rqg = [header 32B][G rows * K bytes], mmap(PROT_READ)으로 읽음
+//    header: [magic "RQGM"][version 2B][0 2B][K 4B][rows 4B][checksum 8B][0 8B] (big-endian)
+//    · checksum = xxh64(G, seed = xxh64(header[0, 16))) -> 잘린 / 손상된 / 다른 version 파일은 다시 추출
+//    · 다른 libRaptorQ build로 만든 파일은 구분하지 않음 (라이브러리를 바꾸면 디렉터리를 지울 것)
+//  - G가 MATRIX_CACHE_MAX_BYTES보다 커지는 K (큰 Block_Size)는 cache하지 않음 -> 기존 경로
+// ===================================================================
+const uint16_t MATRIX_CACHE_VERSION = 1;
+const size_t MATRIX_CACHE_HEADER_SIZE = 32;
+const size_t MATRIX_CACHE_MAX_BYTES = 16u << 20;    // 파일 하나 (G), 추출 버퍼 (K * K)
+const char* const DEFAULT_MATRIX_CACHE_DIR = "../data/matrix_cache";
+
+class RepairMatrix {
+public:
+    RepairMatrix(uint32_t num_source_symbols, uint32_t rows, std::vector<uint8_t> coefficients);
+    RepairMatrix(uint32_t num_source_symbols, uint32_t rows, const uint8_t* mapped, void* map_base, size_t map_length);
+    ~RepairMatrix();
+
+    RepairMatrix(const RepairMatrix&) = delete;
+    RepairMatrix& operator=(const RepairMatrix&) = delete;
+
+    uint32_t numSourceSymbols() const { return _k; }
+    uint32_t rows() const { return _rows; }
+    bool mapped() const { return _map_base != nullptr; }
+    const uint8_t* row(uint32_t r) const { return _g + static_cast<size_t>(r) * _k; }
+
+    // ESI = K + r 인 repair symbol (block: K * T bytes, 0-padding 포함), r < rows()
+    void encodeRepair(uint32_t r, const uint8_t* block, uint16_t symbol_size, uint8_t* out) const;
+
+private:
+    uint32_t _k;
+    uint32_t _rows;
+    std::vector<uint8_t> _owned;
+    const uint8_t* _g;
+    void* _map_base = nullptr;
+    size_t _map_length = 0;
+};
+
+class MatrixCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;          // 이 프로세스 / 디스크에 이미 있던 G
+        uint64_t loaded = 0;        // 그중 디스크에서 mmap한 파일
+        uint64_t extracted = 0;     // compute_sync로 새로 추출 (파일로 저장)
+        uint64_t invalid = 0;       // magic / version / 크기 / checksum이 맞지 않아 버린 파일
+        uint64_t skipped = 0;       // K가 너무 커서 cache하지 않음
+    };
+
+    // dir이 비어 있으면 프로세스 안에서만 유지 (파일 없음)
+    explicit MatrixCache(std::string dir);
+
+    // K에 대해 repair 행이 rows개 이상인 G (없으면 추출 후 저장), cache할 수 없으면 nullptr
+    //  - 여러 thread에서 호출 가능 (encode_blocks_parallel worker)
+    std::shared_ptr<const RepairMatrix> get(RaptorQ__v1::Block_Size block, uint32_t rows);
+
+    const std::string& dir() const { return _dir; }
+    Stats stats() const;
+    // "hits 2 (2 from disk), extracted 0" (도구의 결과 출력용)
+    std::string summary() const;
+
+private:
+    std::string path(uint32_t k) const;
+    std::shared_ptr<const RepairMatrix> load(uint32_t k, uint32_t rows);
+    std::shared_ptr<const RepairMatrix> extract(RaptorQ__v1::Block_Size block, uint32_t rows);
+    void store(const RepairMatrix& matrix);
+
+    std::string _dir;
+    mutable std::mutex _mutex;
+    std::map<uint32_t, std::shared_ptr<const RepairMatrix>> _matrices;
+    Stats _stats;
+};
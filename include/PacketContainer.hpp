@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+// ===================================================================
+// Binary packet container (.fecb)
+//  - base64 텍스트(줄마다 +33%, getline + decode) 대신 고정 크기 레코드
+//  - [Header 48B] + [Payload ID 4B | symbol T bytes (| CRC32C 4B)] * num_records
+//    (version 1 파일은 32B 헤더, content hash 없음 -> 그대로 읽음)
+//  - 디코더는 mmap 후 레코드 포인터를 add_symbol()에 바로 넘김
+//  - 모든 정수는 little-endian
+// ===================================================================
+const char CONTAINER_MAGIC[4] = { 'F', 'E', 'C', 'B' };
+const uint16_t CONTAINER_VERSION = 2;
+const size_t CONTAINER_HEADER_SIZE = 48;
+const size_t CONTAINER_V1_HEADER_SIZE = 32;
+
+struct ContainerHeader {
+    uint16_t version = CONTAINER_VERSION;
+    uint16_t symbol_size = 0;           // T
+    uint64_t transfer_length = 0;       // 원본 크기 (bytes)
+    uint32_t num_source_symbols = 0;    // K (첫 번째 source block 기준)
+    uint16_t num_blocks = 1;            // Z (블록별 K는 partition_source_blocks로 계산)
+    uint16_t record_size = 0;           // PAYLOAD_ID_SIZE + T
+    uint32_t num_records = 0;           // 0이면 파일 크기로 계산 (쓰는 중에 끊긴 파일)
+    bool has_hash = false;              // v2: content_hash가 유효함
+    uint64_t content_hash = 0;          // 원본 전체의 xxHash64 (TransferMeta와 같은 값)
+};
+
+class ContainerWriter {
+public:
+    ~ContainerWriter();
+    bool open(const std::string& path, const ContainerHeader& header);
+    bool append(const uint8_t* record, size_t size);
+    // 헤더의 num_records를 실제 개수로 갱신하고 닫음
+    bool close();
+    uint32_t count() const { return _header.num_records; }
+    // 스트리밍 인코더처럼 F/K/Z를 다 쓴 뒤에 알게 되는 경우 close() 전에 갱신
+    ContainerHeader& header() { return _header; }
+private:
+    std::ofstream _out;
+    ContainerHeader _header;
+};
+
+class ContainerReader {
+public:
+    ContainerReader() = default;
+    ContainerReader(const ContainerReader&) = delete;
+    ContainerReader& operator=(const ContainerReader&) = delete;
+    ~ContainerReader();
+
+    // 파일 앞 4바이트가 "FECB"인지 확인 (텍스트 파일과 구분)
+    static bool isContainer(const std::string& path);
+
+    bool open(const std::string& path);
+    void close();
+
+    const ContainerHeader& header() const { return _header; }
+    size_t size() const { return _num_records; }
+    size_t recordSize() const { return _header.record_size; }
+    // i번째 레코드 [Payload ID | symbol] (mmap 영역을 직접 가리킴)
+    const uint8_t* record(size_t i) const { return _data + _header_size + i * _header.record_size; }
+
+private:
+    const uint8_t* _data = nullptr;
+    size_t _length = 0;
+    size_t _num_records = 0;
+    size_t _header_size = CONTAINER_HEADER_SIZE;
+    ContainerHeader _header;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include "FecBlocks.hpp"
+#include "LoRaAirtime.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// ===================================================================
+// MTU-aware packetizer
+//  - LoRa 프레임 하나(AT+SEND payload, Base64 문자 기준)에 심볼 여러 개를 묶음
+//  - Frame: [n 1B][Payload ID 4B (첫 심볼의 SBN | ESI)][symbol * n]
+//    · 한 프레임의 심볼은 같은 SBN, 연속된 ESI
+//    · T = (frame_len - 5) / n  -> 디코더는 프레임만 보고 심볼을 나눌 수 있음
+//  - choose_packing(): MTU 안에서 전체 airtime이 가장 짧은 (T, n) 선택
+// ===================================================================
+const size_t FRAME_HEADER_SIZE = 1 + PAYLOAD_ID_SIZE;
+const size_t DEFAULT_LORA_MTU = 240;    // AT+SEND 최대 payload (문자)
+
+struct Packing {
+    uint16_t symbol_size = 32;          // T
+    uint8_t symbols_per_frame = 1;      // n
+    uint32_t frames = 0;                // 전체 프레임 수
+    double airtime_ms = 0.0;            // 전체 프레임의 airtime 합
+};
+
+// transfer_length 바이트를 overhead_ratio(%)로 인코딩했을 때의 프레임 수 / airtime
+Packing estimate_packing(size_t transfer_length, double overhead_ratio, uint16_t symbol_size,
+                         uint8_t symbols_per_frame, const LoRaParams& params, uint32_t min_blocks = 1);
+
+// mtu_chars: Base64로 보낼 수 있는 최대 문자 수
+//  - 모든 T에 대해 MTU에 들어가는 최대 n을 계산하고 airtime 합이 최소인 조합을 반환
+//  - MTU가 너무 작으면 symbols_per_frame == 0
+Packing choose_packing(size_t transfer_length, double overhead_ratio, size_t mtu_chars,
+                       const LoRaParams& params, uint32_t min_blocks = 1);
+
+// 프레임 하나를 나눈 결과 (symbols는 입력 버퍼를 가리킴)
+struct FrameView {
+    uint8_t count = 0;
+    uint8_t sbn = 0;
+    uint32_t first_esi = 0;
+    uint16_t symbol_size = 0;
+    const uint8_t* symbols = nullptr;   // symbol i = symbols + i * symbol_size
+};
+
+// 길이가 맞지 않는 프레임(n == 0, 나누어 떨어지지 않음)은 false
+bool parse_frame(const uint8_t* frame, size_t len, FrameView& out);
+
+class Packetizer {
+public:
+    using FrameSink = std::function<bool(const uint8_t* frame, size_t size)>;
+
+    Packetizer(uint16_t symbol_size, uint8_t symbols_per_frame, FrameSink sink);
+
+    // [Payload ID | symbol] 패킷 하나 추가, 프레임이 차거나 ESI가 끊기면 sink로 내보냄
+    bool add(const uint8_t* packet);
+    // 남은 심볼을 프레임으로 내보냄 (블록 끝, 파일 끝)
+    bool flush();
+
+private:
+    uint16_t _symbol_size;
+    uint8_t _max_symbols;
+    FrameSink _sink;
+    std::vector<uint8_t> _frame;
+    uint8_t _count = 0;
+    uint8_t _sbn = 0;
+    uint32_t _next_esi = 0;
+};
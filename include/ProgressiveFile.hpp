@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// ===================================================================
+// Progressive output file
+//  - 크기를 미리 잡아 두고(ftruncate) 도착한 source symbol을 제자리에 pwrite()
+//  - 블록 디코딩이 끝나면 빠진 구간(hole)만 채움 -> 첫 바이트가 블록 완료를 기다리지 않음
+//  - 아직 받지 못한 구간은 0으로 남음 (유효 구간은 FecDecoder::validRanges())
+// ===================================================================
+class ProgressiveFile {
+public:
+    ProgressiveFile() = default;
+    ProgressiveFile(const ProgressiveFile&) = delete;
+    ProgressiveFile& operator=(const ProgressiveFile&) = delete;
+    ~ProgressiveFile();
+
+    bool open(const std::string& path, uint64_t size);
+    bool write(uint64_t offset, const uint8_t* data, size_t len);
+    void close();
+
+    bool isOpen() const { return _fd >= 0; }
+    uint64_t bytesWritten() const { return _written; }
+
+private:
+    int _fd = -1;
+    uint64_t _size = 0;
+    uint64_t _written = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include "FecBlocks.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// ===================================================================
+// Rateless encoder (send-until-done)
+//  - 블록마다 compute_sync()한 Encoder를 유지하고 repair symbol을 필요할 때마다 생성
+//    (ESI = K, K+1, ... begin_repair()부터 이어서, 미리 정한 ceil(K * overhead) 개수 없음)
+//  - 패킷 형식은 다른 인코더와 같은 [Payload ID 4B | symbol]
+// ===================================================================
+class RatelessEncoder {
+public:
+    using InputIt = std::vector<uint8_t>::iterator;
+    using OutputIt = uint8_t*;
+    using Encoder = RaptorQ__v1::Encoder<InputIt, OutputIt>;
+
+    RatelessEncoder(std::vector<uint8_t> data, uint16_t symbol_size, uint32_t min_blocks = 1);
+
+    // 분할 실패(Z > 256) 또는 compute_sync() 실패면 false
+    bool valid() const { return _valid; }
+
+    const std::vector<SourceBlock>& blocks() const { return _blocks; }
+    uint16_t symbolSize() const { return _symbol_size; }
+    size_t packetSize() const { return PAYLOAD_ID_SIZE + _symbol_size; }
+
+    // source symbol 패킷 (esi < K)
+    void sourcePacket(uint8_t sbn, uint32_t esi, uint8_t* packet);
+    // 이 블록에서 아직 만들지 않은 다음 repair symbol 패킷, ESI가 24 bit를 넘으면 false
+    bool nextRepairPacket(uint8_t sbn, uint8_t* packet);
+    uint32_t repairGenerated(uint8_t sbn) const { return _next_esi[sbn] - static_cast<uint32_t>(_blocks[sbn].block); }
+
+private:
+    std::vector<uint8_t> _data;
+    uint16_t _symbol_size;
+    std::vector<SourceBlock> _blocks;
+    std::vector<std::unique_ptr<Encoder>> _encoders;
+    std::vector<uint32_t> _next_esi;
+    bool _valid = false;
+};
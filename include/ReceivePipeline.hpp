@@ -0,0 +1,97 @@
+#pragma once
+#include "LoRaModule.hpp"
+#include "SpscRing.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+
+// ===================================================================
+// Multi-threaded receive pipeline
+//  [serial reader] --raw ring--> [parser: Base64] --packet ring--> [decoder]
+//  - stage 사이는 미리 할당된 slot의 lock-free SPSC ring
+//  - wait_sync()가 오래 걸려도 reader는 계속 serial을 비움
+//    (raw ring이 가득 차면 frame을 버리고 overrun으로 셈, FEC가 복구)
+//  - 송신(feedback)도 serial을 가진 reader thread가 receive() 사이에 처리
+// ===================================================================
+const size_t PIPELINE_MAX_LINE = 256;     // +RCV data (Base64, MTU 240 이상)
+const size_t PIPELINE_MAX_PACKET = 192;   // Base64 디코딩 결과
+
+struct RawSlot {
+    uint16_t len = 0;
+    int16_t rssi = 0;
+    int16_t snr = 0;
+    int address = 0;
+    char data[PIPELINE_MAX_LINE];
+};
+
+struct PacketSlot {
+    uint16_t len = 0;
+    int address = 0;
+    uint8_t data[PIPELINE_MAX_PACKET];
+};
+
+class ReceivePipeline {
+public:
+    // decoder thread에서 패킷마다 호출, true를 반환하면 수신 종료
+    using PacketConsumer = std::function<bool(const uint8_t* packet, size_t len, int address)>;
+    // decoder thread에서 호출 (consumer와 같은 thread -> 디코더 상태를 그대로 읽어도 됨)
+    using IdleHandler = std::function<void()>;
+
+    struct Stats {
+        uint64_t frames = 0;        // reader가 받은 +RCV
+        uint64_t overruns = 0;      // raw ring이 가득 차서 버린 frame
+        uint64_t rejected = 0;      // Base64 오류 / 너무 긴 payload
+        uint64_t packets = 0;       // decoder stage가 처리한 패킷
+        size_t raw_depth = 0, raw_high_water = 0, raw_capacity = 0;
+        size_t packet_depth = 0, packet_high_water = 0, packet_capacity = 0;
+    };
+
+    explicit ReceivePipeline(LoRaModule& module, size_t ring_capacity = 256);
+
+    // consumer가 true를 반환하거나 idle_timeout_ms 동안 frame이 없으면 종료
+    //  - report_interval_ms > 0 이면 호출한 thread에서 주기적으로 ring 사용량 출력
+    //  - consumer가 끝냈으면 true
+    bool run(const PacketConsumer& consumer, int idle_timeout_ms, int report_interval_ms = 0);
+
+    Stats stats() const;
+
+    // payload를 AT+SEND로 보냄 (어느 thread에서나 호출 가능, 실제 전송은 reader thread)
+    //  - run()이 끝날 때 남은 payload는 모두 보낸 뒤 종료
+    void send(std::string payload, int address);
+    // gap_ms 동안 새 패킷이 없으면 (그 뒤로도 gap_ms마다) handler 호출, run() 전에 설정
+    void setIdleHandler(int gap_ms, IdleHandler handler);
+    // consumer가 true를 반환한 것처럼 수신 종료 (idle handler 등 decoder thread에서 호출)
+    void finish() { _done = true; }
+
+private:
+    void flushOutbox();
+
+    void readerLoop();
+    void parserLoop();
+    void decoderLoop(const PacketConsumer& consumer);
+
+    LoRaModule& _module;
+    SpscRing<RawSlot> _raw;
+    SpscRing<PacketSlot> _packets;
+
+    std::atomic<bool> _stop{false};
+    std::atomic<bool> _done{false};
+    std::atomic<bool> _reader_finished{false};
+    std::atomic<bool> _parser_finished{false};
+    std::atomic<int64_t> _last_frame_ms{0};
+
+    std::atomic<uint64_t> _frames{0};
+    std::atomic<uint64_t> _overruns{0};
+    std::atomic<uint64_t> _rejected{0};
+    std::atomic<uint64_t> _processed{0};
+
+    std::mutex _outbox_mutex;
+    std::deque<std::pair<std::string, int>> _outbox;   // (payload, address)
+    int _idle_gap_ms = 0;
+    IdleHandler _idle_handler;
+};
@@ -3,13 +3,42 @@
 #include <vector>
 #include <cstdint>
 #include <termios.h>
+#include <sys/uio.h>
+
+// 수신 버퍼 안의 한 줄 (복사 없음, 다음 readLine()/flushInput() 전까지만 유효)
+//  - "\r\n"은 포함하지 않음, 바로 뒤에 '\r' 또는 '\n'이 있음
+struct LineView {
+    const char* data = nullptr;
+    size_t size = 0;
+};
 
 class SerialPort {
 public:
     SerialPort(const std::string& port_name, speed_t baud_rate);
     ~SerialPort();
     ssize_t write(const std::vector<uint8_t>& data);
+    // scatter/gather write: 여러 조각을 이어 붙이지 않고 한 번에 보냄 (부분 write는 이어서 처리)
+    ssize_t writev(const struct iovec* iov, int count);
     ssize_t read(std::vector<uint8_t>& buffer);
+    // poll() 기반 대기: timeout_ms 안에 읽을 데이터가 생기면 true (timeout_ms < 0 이면 무한 대기)
+    bool waitReadable(int timeout_ms);
+    // non-blocking read, 읽을 게 없으면 0
+    ssize_t readSome(uint8_t* buffer, size_t capacity);
+    // 다음 완성된 줄 (CRLF / LF 기준), timeout_ms 안에 없으면 false (0: 기다리지 않음)
+    //  - read()가 줄 중간에서 끊겨도 나머지는 버퍼에 남아 다음 read와 이어짐
+    bool readLine(LineView& line, int timeout_ms);
+    // 아직 읽지 않은 수신 데이터를 버림 (이전 명령의 늦은 응답 제거)
+    void flushInput();
+    int fd() const { return _fd; }
 private:
+    // 줄 단위 수신 버퍼: [_rx_start, _rx_end) 가 아직 꺼내지 않은 데이터
+    //  - 끝에 공간이 없으면 남은 데이터를 앞으로 옮김 -> 줄은 항상 연속된 메모리
+    static const size_t RX_BUFFER_SIZE = 4096;
+    bool fillBuffer();
+
     int _fd = -1;
+    std::vector<char> _rx;
+    size_t _rx_start = 0;
+    size_t _rx_end = 0;
+    size_t _rx_scanned = 0;     // '\n'을 이미 찾아본 위치 (같은 바이트를 다시 검사하지 않음)
 };
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// ===================================================================
+// Lock-free single-producer / single-consumer ring
+//  - slot은 생성 시 미리 할당 (수신 중 heap 할당 없음)
+//  - producer: writeSlot()에 직접 채운 뒤 commitWrite()
+//  - consumer: readSlot()에서 직접 읽은 뒤 commitRead()
+//  - head/tail을 각각 다른 cache line에 두어 false sharing 방지
+// ===================================================================
+template <typename T>
+class SpscRing {
+public:
+    // capacity는 2의 거듭제곱으로 올림
+    explicit SpscRing(size_t capacity)
+    {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        _slots.resize(n);
+        _mask = n - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // [producer] 비어 있는 slot, 가득 찼으면 nullptr
+    T* writeSlot()
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _cached_tail > _mask) {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+            if (head - _cached_tail > _mask) return nullptr;
+        }
+        return &_slots[head & _mask];
+    }
+
+    // [producer] writeSlot()로 받은 slot을 consumer에게 넘김
+    void commitWrite()
+    {
+        const size_t head = _head.load(std::memory_order_relaxed) + 1;
+        _head.store(head, std::memory_order_release);
+        const size_t used = head - _tail.load(std::memory_order_relaxed);
+        if (used > _high_water.load(std::memory_order_relaxed)) _high_water.store(used, std::memory_order_relaxed);
+    }
+
+    // [consumer] 다음 slot, 비어 있으면 nullptr
+    T* readSlot()
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _cached_head) {
+            _cached_head = _head.load(std::memory_order_acquire);
+            if (tail == _cached_head) return nullptr;
+        }
+        return &_slots[tail & _mask];
+    }
+
+    // [consumer] readSlot()로 받은 slot을 producer에게 돌려줌
+    void commitRead()
+    {
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 현재 사용 중인 slot 수 (어느 thread에서나 근사값)
+    size_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+    size_t capacity() const { return _mask + 1; }
+    size_t highWater() const { return _high_water.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<T> _slots;
+    size_t _mask = 0;
+
+    char _pad0[64];
+    std::atomic<size_t> _head{0};       // producer가 씀
+    size_t _cached_tail = 0;            // producer 전용
+    char _pad1[64];
+    std::atomic<size_t> _tail{0};       // consumer가 씀
+    size_t _cached_head = 0;            // consumer 전용
+    char _pad2[64];
+    std::atomic<size_t> _high_water{0};
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include "FecBlocks.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// Bounded-memory streaming encoder
+//  - 파일 전체를 vector로 읽지 않고 source block 하나씩 pread()로 읽음
+//  - 현재 블록을 인코딩하는 동안 다음 블록을 미리 읽음 (double buffer)
+//  - repair symbol은 ESI 구간으로 나눠 여러 thread에서 생성 (repair arena, 패킷 순서는 그대로)
+//  - 메모리 사용량: 최대 2 블록 + 블록 하나의 repair 패킷 (파일 크기와 무관)
+// ===================================================================
+class MatrixCache;
+
+class StreamEncoder {
+public:
+    // 패킷 하나([Payload ID | symbol])가 만들어질 때마다 호출, false면 중단
+    using PacketSink = std::function<bool(const uint8_t* packet, size_t size)>;
+
+    StreamEncoder(uint16_t symbol_size, double overhead_ratio);
+
+    // 설정하면 K별 repair 계수(MatrixCache.hpp)로 블록마다의 compute_sync 생략 (encodeFile 전에)
+    void setMatrixCache(MatrixCache* cache) { _matrix_cache = cache; }
+
+    // repair 생성 thread 수 (0 = hardware_concurrency(), 1 = 호출한 thread만)
+    void setThreads(unsigned num_threads) { _num_threads = num_threads; }
+
+    // max_block_bytes: 한 블록의 최대 크기 (0 = Block_Size 한계까지)
+    bool encodeFile(const std::string& path, size_t max_block_bytes, const PacketSink& sink);
+
+    // encodeFile()과 같은 블록 분할 (metadata record의 Z / K를 첫 패킷 전에 알아야 할 때)
+    //  - max_block_bytes는 soft cap: 블록이 MAX_SOURCE_BLOCKS개를 넘게 되면 블록을 K_max * T까지 키움
+    //  - maxTransferLength()보다 큰 파일이면 빈 vector
+    static std::vector<SourceBlock> partition(uint64_t transfer_length, uint16_t symbol_size, size_t max_block_bytes);
+
+    // MAX_SOURCE_BLOCKS * K_max * T (스트리밍 인코더가 받을 수 있는 최대 파일 크기)
+    static uint64_t maxTransferLength(uint16_t symbol_size);
+
+    // 파일 전체의 xxHash64와 길이 (metadata record용, 인코딩 전에 1 MiB씩 순차로 읽음)
+    static bool hashFile(const std::string& path, uint64_t& hash, uint64_t& length);
+
+    const std::vector<SourceBlock>& blocks() const { return _blocks; }
+    uint64_t transferLength() const { return _transfer_length; }
+    uint64_t packetsEmitted() const { return _packets; }
+
+private:
+    bool readBlock(int fd, const SourceBlock& sb, std::vector<uint8_t>& buffer);
+    bool encodeBlock(const SourceBlock& sb, std::vector<uint8_t>& buffer, const PacketSink& sink);
+
+    uint16_t _symbol_size;
+    double _overhead_ratio;
+    uint64_t _transfer_length = 0;
+    uint64_t _packets = 0;
+    std::vector<SourceBlock> _blocks;
+    MatrixCache* _matrix_cache = nullptr;
+    unsigned _num_threads = 0;
+    std::vector<uint8_t> _repair_arena;     // 현재 블록의 repair 패킷 [ID | symbol] * R
+};
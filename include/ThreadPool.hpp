@@ -0,0 +1,79 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ===================================================================
+// Fixed-size thread pool
+//  - submit()한 작업을 worker들이 FIFO 순서로 가져감
+//  - 결과/예외는 std::future로 돌려받음
+//  - 소멸자는 남은 작업을 모두 끝낸 뒤 worker를 join
+// ===================================================================
+class ThreadPool {
+public:
+    // num_threads == 0 이면 hardware_concurrency() 사용
+    explicit ThreadPool(unsigned num_threads = 0)
+    {
+        if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0) num_threads = 1;
+        for (unsigned i = 0; i < num_threads; ++i) _workers.emplace_back(&ThreadPool::run, this);
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _cv.notify_all();
+        for (auto& th : _workers) th.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <class F>
+    std::future<typename std::result_of<F()>::type> submit(F task)
+    {
+        using R = typename std::result_of<F()>::type;
+        auto packaged = std::make_shared<std::packaged_task<R()>>(std::move(task));
+        std::future<R> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.emplace_back([packaged]() { (*packaged)(); });
+        }
+        _cv.notify_one();
+        return result;
+    }
+
+    size_t size() const { return _workers.size(); }
+
+private:
+    void run()
+    {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+                if (_tasks.empty()) return;
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stopping = false;
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// ===================================================================
+// Transfer metadata record (심볼 스트림 안에 데이터 패킷처럼 Base64 한 줄로 전송)
+//  - version 2 (RFC 6330 3.3 Object Transmission Information + content hash) = 30 bytes, big-endian
+//    [magic 0xFE][version 2][flags][F 5B][T 2B][Z 2B][K 2B][transfer ID 4B][content hash 8B][CRC32C 4B]
+//    · F / T / Z / K: 디코더가 하드코딩 없이 출력 버퍼와 블록별 Decoder를 만들 수 있음
+//      (블록별 K는 partition_source_blocks(F, T, Z)로 계산, K는 SBN 0의 Block_Size로 분할 확인용)
+//    · transfer ID: 같은 송신 측의 다른 전송과 구분 (OTI + hash에서 계산, 다시 보내도 같은 값)
+//    · flags bit 0: content hash 유효 (hash를 모르는 v1 컨테이너에서 만든 record는 0)
+//    · content hash: 원본 전체의 xxHash64 (XxHash64.hpp) -> 디코딩 결과가 "완성됐지만 틀린" 경우 검출
+//    · CRC32C: record 자체의 손상 / 데이터 패킷과의 우연한 일치 방지
+//  - version 1 (22 bytes: [magic][1][F 8B][hash 8B][CRC32C 4B])도 계속 읽음 (OTI 없음)
+//  - 인코더는 스트림 처음, META_REPEAT_INTERVAL개의 데이터 줄마다, 끝에 한 번씩
+//    -> 앞부분이 손실돼도 디코더는 먼저 도착한 사본으로 Decoder를 만듦
+//  - 디코더는 magic + 길이 + CRC가 모두 맞을 때만 metadata로 처리 (아니면 일반 패킷)
+// ===================================================================
+const uint8_t META_MAGIC = 0xFE;
+const uint8_t META_VERSION = 2;
+const size_t META_RECORD_SIZE = 30;         // 현재 version (버퍼 크기는 이 값으로)
+const size_t META_V1_RECORD_SIZE = 22;
+const uint32_t META_REPEAT_INTERVAL = 16;
+const uint64_t META_MAX_TRANSFER_LENGTH = (uint64_t(1) << 40) - 1;
+
+struct TransferMeta {
+    uint64_t transfer_length = 0;   // F
+    uint16_t symbol_size = 0;       // T
+    uint16_t num_blocks = 0;        // Z
+    uint16_t num_source_symbols = 0;// K (SBN 0)
+    uint32_t transfer_id = 0;
+    bool has_oti = false;           // T / Z / K / transfer ID 유효 (version 2)
+    bool has_hash = false;
+    uint64_t content_hash = 0;      // xxh64(원본, seed 0)
+};
+
+// 인코더용: OTI + hash를 채우고 transfer ID 계산 (hash를 모르면 has_hash = false)
+TransferMeta make_transfer_meta(uint64_t transfer_length, uint16_t symbol_size, uint16_t num_blocks,
+                                uint16_t num_source_symbols, bool has_hash, uint64_t content_hash);
+
+// out은 META_RECORD_SIZE 이상, 쓴 길이 반환 (항상 version 2)
+size_t encode_transfer_meta(const TransferMeta& meta, uint8_t* out);
+// magic / 길이 / version / CRC가 맞지 않으면 false
+bool parse_transfer_meta(const uint8_t* data, size_t len, TransferMeta& out);
+
+// Base64 텍스트 파일에서 첫 번째 metadata record를 찾음 (OTI가 있는 record 우선)
+//  - 파일 디코더가 Decoder를 만들기 전에 한 번 훑어봄 (첫 줄이 손실돼도 반복된 사본 사용)
+bool scan_transfer_meta(const std::string& path, TransferMeta& out);
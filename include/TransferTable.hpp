@@ -0,0 +1,164 @@
+#pragma once
+#include "FecDecoder.hpp"
+#include "ProgressiveFile.hpp"
+#include "ThreadPool.hpp"
+#include "TransferMeta.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ===================================================================
+// Multi-transfer demultiplexer (gateway 수신 경로)
+//  - 여러 송신 측이 동시에 보내는 전송을 (address, transfer ID)별 FecDecoder로 나눔
+//    · 데이터 패킷에는 transfer ID가 없음 -> 주소마다 "현재 전송" = 그 주소에서 마지막으로 받은 OTI record
+//    · 처음 보는 주소의 패킷은 OTI record가 올 때까지 보관했다가 Decoder 생성 직후 다시 넣음
+//    · 현재 전송이 끝난 뒤의 패킷은 버림 (이전 전송의 repair를 다음 전송에 섞지 않음)
+//      완료한 전송이면 LATE_PACKETS event (송신 측이 DONE을 받지 못함 -> gateway가 DONE 재전송, rate-limited)
+//  - 메모리 상한: 전송마다 F + 블록 심볼 버퍼(추정치)를 합산
+//    · 새 전송이 들어오지 못하면 가장 오래 갱신되지 않은 미완료 전송부터 제거 (LRU)
+//    · stale_ms 동안 패킷이 없는 미완료 전송도 제거 (받은 구간은 출력 파일에 남음)
+//    · 제거한 전송은 evict_backoff_ms 동안 반복되는 OTI record로 다시 시작하지 않음
+//      (같은 전송이 다시 제거될 때마다 2배, stale_ms까지) -> 메모리가 부족할 때 서로 밀어내며 반복하지 않음
+//  - 모든 블록이 ready가 된 전송은 worker thread에서 decode() + content hash 확인
+//    -> 큰 이미지의 행렬 디코딩이 작은 텍스트 전송의 수신을 막지 않음
+//    (source symbol만으로 끝난 전송은 행렬 디코딩이 없으므로 바로 완료)
+//  - addPacket() / poll() / drain()은 한 thread(ReceivePipeline decoder thread)에서만 호출
+// ===================================================================
+class TransferTable {
+public:
+    struct Options {
+        std::string output_dir = ".";
+        uint64_t memory_budget = 64ull << 20;   // bytes
+        int stale_ms = 10 * 60 * 1000;
+        unsigned workers = 0;                   // 0: hardware_concurrency()
+        size_t max_waiting_packets = 256;       // 주소별, OTI record 전
+        int done_resend_ms = 1000;              // 완료한 전송의 LATE_PACKETS event 최소 간격
+        int evict_backoff_ms = 30 * 1000;       // 제거한 전송을 다시 시작하기까지 (처음)
+    };
+
+    enum class EventType {
+        STARTED,        // 새 전송 (OTI record로 Decoder 생성)
+        COMPLETED,      // 복원 완료 (hash_verified: metadata hash와 일치)
+        REOPENED,       // hash 불일치 / rank 부족 -> 해당 블록을 다시 받음
+        FAILED,         // wait_sync() / decode_bytes() 오류
+        EVICTED,        // 메모리 상한(LRU) / stale timeout으로 제거
+        REJECTED,       // 한 전송이 메모리 상한보다 큼 / 잘못된 OTI
+        LATE_PACKETS,   // 완료한 전송의 패킷 / record가 계속 옴 (DONE 손실), COMPLETED event와 같은 내용
+    };
+
+    struct Event {
+        EventType type;
+        int address = 0;
+        uint32_t transfer_id = 0;
+        uint64_t transfer_length = 0;
+        std::string path;                   // 출력 파일
+        bool hash_verified = false;
+        uint64_t valid_bytes = 0;           // EVICTED / FAILED: 출력 파일에 남은 유효 구간
+        std::string ranges;                 // format_ranges(validRanges())
+        uint32_t symbols_arrived = 0;       // COMPLETED: 손실률 report (Feedback DONE)
+        uint32_t symbols_expected = 0;
+        double elapsed_s = 0.0;             // STARTED부터
+        const char* reason = "";
+    };
+    using EventSink = std::function<void(const Event& event)>;
+
+    struct Stats {
+        uint64_t started = 0, completed = 0, failed = 0, evicted = 0, rejected = 0;
+        uint64_t packets_routed = 0;        // 전송의 Decoder에 넣은 패킷
+        uint64_t packets_replayed = 0;      // OTI 전에 보관했다가 넣은 패킷
+        uint64_t packets_dropped = 0;       // 보관 한도 초과 / 끝난 전송 뒤의 패킷 / 디코딩 중인 전송
+        uint64_t memory_in_use = 0, memory_high_water = 0;
+        size_t active = 0, decoding = 0;
+    };
+
+    TransferTable(const Options& options, EventSink sink);
+
+    TransferTable(const TransferTable&) = delete;
+    TransferTable& operator=(const TransferTable&) = delete;
+
+    void addPacket(const uint8_t* packet, size_t len, int address);
+    // worker가 끝낸 디코딩 결과 반영 + stale 전송 제거 (패킷이 없을 때도 주기적으로 호출)
+    void poll();
+    // 진행 중인 디코딩을 모두 기다린 뒤 poll() (종료 전)
+    void drain();
+
+    // 수신 중인 전송(각 주소의 현재 전송)마다 fn(address, decoder) - rateless NEED feedback용
+    void forEachReceiving(const std::function<void(int address, const FecDecoder& fec)>& fn) const;
+
+    Stats stats() const;
+
+private:
+    enum class State { RECEIVING, DECODING };
+    using Key = std::pair<int, uint32_t>;   // (address, transfer ID)
+
+    struct Transfer {
+        Key key;
+        TransferMeta meta;
+        std::unique_ptr<FecDecoder> fec;
+        ProgressiveFile file;
+        std::string path;
+        uint64_t footprint = 0;
+        int64_t started_ms = 0;
+        int64_t last_update_ms = 0;
+        State state = State::RECEIVING;
+    };
+
+    struct AddressState {
+        Transfer* current = nullptr;
+        bool finished = false;              // 현재 전송이 끝남 -> 다음 OTI까지 패킷 버림
+        Key finished_key;                   // finished일 때 끝난 전송
+        std::deque<std::vector<uint8_t>> waiting;
+    };
+
+    // 끝난 / 거부 / 제거한 전송 (반복되는 OTI record로 바로 다시 시작하지 않음)
+    struct Finished {
+        EventType outcome = EventType::COMPLETED;
+        int64_t at_ms = 0;
+        int64_t retry_after_ms = 0;         // EVICTED: 이 시각 이후의 OTI record로 다시 시작
+        uint32_t evictions = 0;
+        int64_t last_late_ms = 0;           // COMPLETED: 마지막 LATE_PACKETS event
+        Event completed;                    // COMPLETED event (LATE_PACKETS로 다시 보냄)
+    };
+
+    // worker -> decoder thread
+    struct Completion {
+        Key key;
+        bool ok = false;
+        FecDecoder::HashStatus hash = FecDecoder::HashStatus::UNKNOWN;
+        size_t reopened = 0;
+        bool rank_deficient = false;        // decode() 실패 + ready() 해제: 블록을 다시 열어 둠
+    };
+
+    void onMeta(const TransferMeta& meta, int address);
+    Transfer* startTransfer(const TransferMeta& meta, int address);
+    void route(Transfer& t, const uint8_t* packet, size_t len);
+    void submitDecode(Transfer& t);
+    void finishDecode(const Completion& c);
+    // 전송 제거 (출력 파일은 남김), event는 호출한 쪽에서
+    void removeTransfer(const Key& key);
+    // 제거 + _finished 기록 (EVICTED: backoff)
+    void evictTransfer(const Key& key, const char* reason);
+    // 끝난 전송의 패킷 / record (COMPLETED면 rate-limited LATE_PACKETS)
+    void onLatePacket(const Key& key);
+    bool makeRoom(uint64_t bytes);
+    Event makeEvent(EventType type, const Transfer& t, const char* reason = "") const;
+
+    Options _opt;
+    EventSink _sink;
+    std::map<Key, std::unique_ptr<Transfer>> _transfers;
+    std::map<int, AddressState> _addresses;
+    std::map<Key, Finished> _finished;
+    Stats _stats;
+    int64_t _last_sweep_ms = 0;
+
+    std::mutex _completion_mutex;
+    std::vector<Completion> _completions;
+    std::unique_ptr<ThreadPool> _pool;      // 마지막 member -> 가장 먼저 소멸 (worker join 후 Transfer 해제)
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// ===================================================================
+// xxHash64 (XXH64, seed 0 기본) - 전송 내용 전체의 무결성 확인용
+//  - 블록 디코딩이 "성공"해도 결과가 틀릴 수 있으므로 (손상된 symbol이 섞인 경우)
+//    인코더가 원본의 hash를 metadata record로 보내고 디코더가 복원 결과와 비교
+//  - streaming: 앞에서부터 확정되는 구간을 순서대로 update() -> 마지막 byte와 동시에 digest()
+//  - 상태는 값 복사 가능 (블록 경계마다 저장해 두고 되돌릴 때 사용)
+// ===================================================================
+class XxHash64 {
+public:
+    explicit XxHash64(uint64_t seed = 0);
+
+    void update(const uint8_t* data, size_t len);
+    // 지금까지 update()한 내용의 hash (상태는 바뀌지 않음, 이어서 update 가능)
+    uint64_t digest() const;
+    uint64_t length() const { return _total; }
+
+private:
+    uint64_t _seed;
+    uint64_t _v[4];
+    uint64_t _total = 0;
+    uint8_t _buf[32];
+    size_t _buf_len = 0;
+};
+
+// 한 번에 계산 (xxh64("", 0) = 0xEF46DB3751D8E999)
+uint64_t xxh64(const uint8_t* data, size_t len, uint64_t seed = 0);
@@ -0,0 +1,471 @@
+#include "Base64Simd.hpp"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BASE64_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define BASE64_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+static const char encode_table[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz"
+    "0123456789"
+    "+/";
+
+//
+// 문자 -> 6-bit 값 (255 = base64 문자가 아님)
+// base64.cpp의 pos_of_char()와 같이 '+'/'-', '/'/'_' 둘 다 허용
+//
+static const uint8_t decode_table[256] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  62, 255,  62, 255,  63,
+     52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 255, 255, 255, 255, 255, 255,
+    255,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+     15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 255, 255, 255, 255,  63,
+    255,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+     41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+static inline bool is_padding(char c) { return c == '=' || c == '.'; }
+
+// SIMD 커널: 처리한 입력 길이를 반환 (encode: 3의 배수, decode: 4의 배수)
+// 나머지는 scalar 코드가 이어서 처리
+typedef size_t (*EncodeKernel)(const uint8_t* in, size_t len, char* out);
+typedef size_t (*DecodeKernel)(const char* in, size_t len, uint8_t* out);
+
+static size_t encode_none(const uint8_t*, size_t, char*) { return 0; }
+static size_t decode_none(const char*, size_t, uint8_t*) { return 0; }
+
+// ===================================================================
+// Scalar
+// ===================================================================
+static void encode_scalar(const uint8_t* in, size_t len, char* out)
+{
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t v = (static_cast<uint32_t>(in[i]) << 16) | (static_cast<uint32_t>(in[i + 1]) << 8) | in[i + 2];
+        *out++ = encode_table[(v >> 18) & 0x3F];
+        *out++ = encode_table[(v >> 12) & 0x3F];
+        *out++ = encode_table[(v >> 6) & 0x3F];
+        *out++ = encode_table[v & 0x3F];
+    }
+    if (len - i == 1) {
+        *out++ = encode_table[in[i] >> 2];
+        *out++ = encode_table[(in[i] & 0x03) << 4];
+        *out++ = '=';
+        *out++ = '=';
+    } else if (len - i == 2) {
+        *out++ = encode_table[in[i] >> 2];
+        *out++ = encode_table[((in[i] & 0x03) << 4) | (in[i + 1] >> 4)];
+        *out++ = encode_table[(in[i + 1] & 0x0F) << 2];
+        *out++ = '=';
+    }
+}
+
+// 첫 번째 base64가 아닌 문자의 위치 (오류가 확인된 뒤에만 호출되는 cold path)
+static size_t first_invalid(const char* in, size_t len)
+{
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(in);
+    size_t i = 0;
+    while (i < len && decode_table[s[i]] <= 63) ++i;
+    return i;
+}
+
+static Base64DecodeResult decode_error(Base64Status status, size_t offset)
+{
+    Base64DecodeResult r = { status, 0, offset };
+    return r;
+}
+
+static Base64DecodeResult decode_scalar(const char* in, size_t len, uint8_t* out)
+{
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(in);
+    size_t written = 0;
+
+    // 본문: 마지막 묶음을 제외한 4문자 묶음
+    //  - 문자마다 분기하지 않고 table 값을 OR로 모아서 끝에 한 번만 검사
+    //  - 손상된 줄도 정상 줄과 같은 비용 (예외, 조기 탈출 없음)
+    const size_t body = (len >= 4) ? (len - 1) / 4 * 4 : 0;
+    uint32_t invalid = 0;
+    for (size_t i = 0; i < body; i += 4) {
+        uint32_t a = decode_table[s[i]], b = decode_table[s[i + 1]];
+        uint32_t c = decode_table[s[i + 2]], d = decode_table[s[i + 3]];
+        invalid |= a | b | c | d;
+        uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+        out[written++] = static_cast<uint8_t>(v >> 16);
+        out[written++] = static_cast<uint8_t>(v >> 8);
+        out[written++] = static_cast<uint8_t>(v);
+    }
+    if (invalid > 63) return decode_error(Base64Status::INVALID_CHARACTER, first_invalid(in, body));
+
+    // 마지막 묶음 (padding 포함 가능, 2~4 문자)
+    const size_t i = body;
+    const size_t rem = len - i;
+    Base64DecodeResult r = { Base64Status::OK, written, 0 };
+    if (rem == 0) return r;
+    if (rem == 1) return decode_error(Base64Status::INVALID_LENGTH, i);
+
+    uint32_t a = decode_table[s[i]], b = decode_table[s[i + 1]];
+    if ((a | b) > 63) return decode_error(Base64Status::INVALID_CHARACTER, i + first_invalid(in + i, 2));
+    out[r.written++] = static_cast<uint8_t>((a << 2) | (b >> 4));
+    if (rem == 2) return r;
+
+    if (is_padding(in[i + 2])) {
+        if (rem == 4 && !is_padding(in[i + 3])) return decode_error(Base64Status::INVALID_CHARACTER, i + 3);
+        return r;
+    }
+    uint32_t c = decode_table[s[i + 2]];
+    if (c > 63) return decode_error(Base64Status::INVALID_CHARACTER, i + 2);
+    out[r.written++] = static_cast<uint8_t>((b << 4) | (c >> 2));
+    if (rem == 3 || is_padding(in[i + 3])) return r;
+
+    uint32_t d = decode_table[s[i + 3]];
+    if (d > 63) return decode_error(Base64Status::INVALID_CHARACTER, i + 3);
+    out[r.written++] = static_cast<uint8_t>((c << 6) | d);
+    return r;
+}
+
+#if defined(BASE64_SIMD_X86)
+// ===================================================================
+// SSSE3 (16 문자 <-> 12 바이트)
+// ===================================================================
+__attribute__((target("ssse3")))
+static inline __m128i enc_unpack_ssse3(__m128i in)
+{
+    // 3바이트 묶음 [b0 b1 b2]를 32-bit lane [b1 b0 b2 b1]로 펼친 뒤 6-bit 값 4개로 분리
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+__attribute__((target("ssse3")))
+static inline __m128i enc_translate_ssse3(__m128i idx)
+{
+    // 6-bit 값 -> 문자: 구간별 offset을 pshufb로 선택
+    const __m128i shift_lut = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+    __m128i r = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+    r = _mm_or_si128(r, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, r), idx);
+}
+
+__attribute__((target("ssse3")))
+static inline bool dec_translate_ssse3(__m128i c, __m128i& values)
+{
+    // 범위 비교로 문자 종류를 구하고, 종류별 offset을 더함
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('Z' + 1)));
+    const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('z' + 1)));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    const __m128i plus  = _mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) return false;
+
+    __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-65));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(-71)));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(4)));
+    shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(19)));
+    shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(16)));
+    values = _mm_add_epi8(c, shift);
+    return true;
+}
+
+__attribute__((target("ssse3")))
+static inline __m128i dec_pack_ssse3(__m128i values)
+{
+    // 6-bit 값 4개 -> 24-bit, 각 lane의 하위 3바이트를 앞쪽 12바이트로 모음
+    const __m128i ab_bc = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i abcd = _mm_madd_epi16(ab_bc, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(abcd, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+__attribute__((target("ssse3")))
+static inline void store12(uint8_t* out, __m128i v)
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), v);
+    uint32_t tail = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+    std::memcpy(out + 8, &tail, 4);
+}
+
+__attribute__((target("ssse3")))
+static size_t encode_ssse3(const uint8_t* in, size_t len, char* out)
+{
+    size_t i = 0;
+    // 16바이트를 읽고 그 중 12바이트만 사용
+    for (; len - i >= 16; i += 12, out += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), enc_translate_ssse3(enc_unpack_ssse3(v)));
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t decode_ssse3(const char* in, size_t len, uint8_t* out)
+{
+    size_t i = 0;
+    for (; len - i >= 16; i += 16, out += 12) {
+        __m128i values;
+        if (!dec_translate_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), values)) break;
+        store12(out, dec_pack_ssse3(values));
+    }
+    return i;
+}
+
+// ===================================================================
+// AVX2 (32 문자 <-> 24 바이트), 남은 부분은 SSSE3 커널로 이어서 처리
+// ===================================================================
+__attribute__((target("avx2")))
+static size_t encode_avx2(const uint8_t* in, size_t len, char* out)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i shift_lut = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+    size_t i = 0;
+    // 각 128-bit lane에 12바이트씩 (두 번째 load는 i+12부터 16바이트 -> 28바이트 필요)
+    for (; len - i >= 28; i += 24, out += 32) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+
+        const __m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i idx = _mm256_or_si256(t1, t3);
+
+        __m256i r = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx);
+        r = _mm256_or_si256(r, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        r = _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, r), idx);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), r);
+    }
+    return i + encode_ssse3(in + i, len - i, out);
+}
+
+__attribute__((target("avx2")))
+static size_t decode_avx2(const char* in, size_t len, uint8_t* out)
+{
+    size_t i = 0;
+    for (; len - i >= 32; i += 32, out += 24) {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+
+        const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), c));
+        const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), c));
+        const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+        const __m256i plus  = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('+'));
+        const __m256i slash = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('/'));
+
+        const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(_mm256_or_si256(digit, plus), slash));
+        if (static_cast<uint32_t>(_mm256_movemask_epi8(valid)) != 0xFFFFFFFFu) break;
+
+        __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-65));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(-71)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(4)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(19)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(16)));
+        const __m256i values = _mm256_add_epi8(c, shift);
+
+        const __m256i ab_bc = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i abcd = _mm256_madd_epi16(ab_bc, _mm256_set1_epi32(0x00011000));
+        __m256i packed = _mm256_shuffle_epi8(abcd, _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        // lane마다 앞 12바이트 -> 연속 24바이트
+        packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(packed, 1));
+    }
+    return i + decode_ssse3(in + i, len - i, out);
+}
+#endif  // BASE64_SIMD_X86
+
+#if defined(BASE64_SIMD_NEON)
+// ===================================================================
+// NEON (aarch64): vld3/vst4 로 3바이트 묶음을 lane 단위로 분리, vqtbl4 로 변환
+// ===================================================================
+static size_t encode_neon(const uint8_t* in, size_t len, char* out)
+{
+    const uint8_t* chars = reinterpret_cast<const uint8_t*>(encode_table);
+    uint8x16x4_t table;
+    table.val[0] = vld1q_u8(chars);
+    table.val[1] = vld1q_u8(chars + 16);
+    table.val[2] = vld1q_u8(chars + 32);
+    table.val[3] = vld1q_u8(chars + 48);
+    uint8_t* dst = reinterpret_cast<uint8_t*>(out);
+
+    size_t i = 0;
+    for (; len - i >= 48; i += 48, dst += 64) {
+        const uint8x16x3_t s = vld3q_u8(in + i);
+        uint8x16x4_t r;
+        r.val[0] = vqtbl4q_u8(table, vshrq_n_u8(s.val[0], 2));
+        r.val[1] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(s.val[0], 4), vshrq_n_u8(s.val[1], 4)), vdupq_n_u8(0x3F)));
+        r.val[2] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(s.val[1], 2), vshrq_n_u8(s.val[2], 6)), vdupq_n_u8(0x3F)));
+        r.val[3] = vqtbl4q_u8(table, vandq_u8(s.val[2], vdupq_n_u8(0x3F)));
+        vst4q_u8(dst, r);
+    }
+    // 36바이트 패킷도 SIMD로 처리되도록 64-bit 레지스터 버전 (24 바이트 -> 32 문자)
+    for (; len - i >= 24; i += 24, dst += 32) {
+        const uint8x8x3_t s = vld3_u8(in + i);
+        uint8x8x4_t r;
+        r.val[0] = vqtbl4_u8(table, vshr_n_u8(s.val[0], 2));
+        r.val[1] = vqtbl4_u8(table, vand_u8(vorr_u8(vshl_n_u8(s.val[0], 4), vshr_n_u8(s.val[1], 4)), vdup_n_u8(0x3F)));
+        r.val[2] = vqtbl4_u8(table, vand_u8(vorr_u8(vshl_n_u8(s.val[1], 2), vshr_n_u8(s.val[2], 6)), vdup_n_u8(0x3F)));
+        r.val[3] = vqtbl4_u8(table, vand_u8(s.val[2], vdup_n_u8(0x3F)));
+        vst4_u8(dst, r);
+    }
+    return i;
+}
+
+static size_t decode_neon(const char* in, size_t len, uint8_t* out)
+{
+    // decode_table[0..127]을 64개씩 두 테이블로 (128 이상은 항상 invalid)
+    uint8x16x4_t lo, hi;
+    for (int k = 0; k < 4; ++k) {
+        lo.val[k] = vld1q_u8(decode_table + 16 * k);
+        hi.val[k] = vld1q_u8(decode_table + 64 + 16 * k);
+    }
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(in);
+
+    size_t i = 0;
+    for (; len - i >= 64; i += 64, out += 48) {
+        const uint8x16x4_t c = vld4q_u8(src + i);
+        uint8x16x4_t v;
+        uint8x16_t any = vdupq_n_u8(0);
+        for (int k = 0; k < 4; ++k) {
+            // 범위 밖 index는 vqtbx가 원래 값(255)을 유지
+            v.val[k] = vqtbx4q_u8(vdupq_n_u8(255), lo, c.val[k]);
+            v.val[k] = vqtbx4q_u8(v.val[k], hi, vsubq_u8(c.val[k], vdupq_n_u8(64)));
+            any = vorrq_u8(any, v.val[k]);
+        }
+        if (vmaxvq_u8(any) > 63) break;
+
+        uint8x16x3_t r;
+        r.val[0] = vorrq_u8(vshlq_n_u8(v.val[0], 2), vshrq_n_u8(v.val[1], 4));
+        r.val[1] = vorrq_u8(vshlq_n_u8(v.val[1], 4), vshrq_n_u8(v.val[2], 2));
+        r.val[2] = vorrq_u8(vshlq_n_u8(v.val[2], 6), v.val[3]);
+        vst3q_u8(out, r);
+    }
+    for (; len - i >= 32; i += 32, out += 24) {
+        const uint8x8x4_t c = vld4_u8(src + i);
+        uint8x8x4_t v;
+        uint8x8_t any = vdup_n_u8(0);
+        for (int k = 0; k < 4; ++k) {
+            v.val[k] = vqtbx4_u8(vdup_n_u8(255), lo, c.val[k]);
+            v.val[k] = vqtbx4_u8(v.val[k], hi, vsub_u8(c.val[k], vdup_n_u8(64)));
+            any = vorr_u8(any, v.val[k]);
+        }
+        if (vmaxv_u8(any) > 63) break;
+
+        uint8x8x3_t r;
+        r.val[0] = vorr_u8(vshl_n_u8(v.val[0], 2), vshr_n_u8(v.val[1], 4));
+        r.val[1] = vorr_u8(vshl_n_u8(v.val[1], 4), vshr_n_u8(v.val[2], 2));
+        r.val[2] = vorr_u8(vshl_n_u8(v.val[2], 6), v.val[3]);
+        vst3_u8(out, r);
+    }
+    return i;
+}
+#endif  // BASE64_SIMD_NEON
+
+// ===================================================================
+// Runtime dispatch (FEC_BASE64_KERNEL=scalar 로 강제 가능, 벤치마크 비교용)
+// ===================================================================
+struct Base64Kernels {
+    const char* name;
+    EncodeKernel encode;
+    DecodeKernel decode;
+};
+
+static Base64Kernels select_kernels()
+{
+    Base64Kernels k = { "scalar", encode_none, decode_none };
+    const char* force = std::getenv("FEC_BASE64_KERNEL");
+    if (force && std::strcmp(force, "scalar") == 0) return k;
+
+#if defined(BASE64_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && !(force && std::strcmp(force, "ssse3") == 0)) {
+        k.name = "avx2"; k.encode = encode_avx2; k.decode = decode_avx2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        k.name = "ssse3"; k.encode = encode_ssse3; k.decode = decode_ssse3;
+    }
+#elif defined(BASE64_SIMD_NEON)
+    k.name = "neon"; k.encode = encode_neon; k.decode = decode_neon;
+#endif
+    return k;
+}
+
+static const Base64Kernels& kernels()
+{
+    static const Base64Kernels k = select_kernels();
+    return k;
+}
+
+const char* base64_kernel_name()
+{
+    return kernels().name;
+}
+
+Base64Status base64_encode_to(const uint8_t* in, size_t len, char* out, size_t out_capacity, size_t& out_len)
+{
+    out_len = 0;
+    const size_t needed = base64_encoded_size(len);
+    if (out_capacity < needed) return Base64Status::OUTPUT_TOO_SMALL;
+
+    const size_t done = kernels().encode(in, len, out);
+    encode_scalar(in + done, len - done, out + done / 3 * 4);
+    out_len = needed;
+    return Base64Status::OK;
+}
+
+Base64DecodeResult base64_decode_checked(const char* in, size_t len, uint8_t* out, size_t out_capacity)
+{
+    if (len % 4 == 1) return decode_error(Base64Status::INVALID_LENGTH, len - 1);
+
+    // 정확한 출력 길이 (끝의 padding 제외)
+    size_t needed = len / 4 * 3 + (len % 4 == 0 ? 0 : len % 4 - 1);
+    if (len % 4 == 0 && len >= 4 && is_padding(in[len - 1])) needed -= is_padding(in[len - 2]) ? 2 : 1;
+    if (out_capacity < needed) return decode_error(Base64Status::OUTPUT_TOO_SMALL, 0);
+
+    // SIMD 커널은 잘못된 문자가 있는 chunk 앞에서 멈추고, 나머지는 scalar가 처리
+    const size_t done = kernels().decode(in, len, out);
+    Base64DecodeResult r = decode_scalar(in + done, len - done, out + done / 4 * 3);
+    if (r.status == Base64Status::OK) r.written += done / 4 * 3;
+    else r.error_offset += done;
+    return r;
+}
+
+Base64Status base64_decode_to(const char* in, size_t len, uint8_t* out, size_t out_capacity, size_t& out_len)
+{
+    const Base64DecodeResult r = base64_decode_checked(in, len, out, out_capacity);
+    out_len = r.written;
+    return r.status;
+}
@@ -0,0 +1,91 @@
+#include "CodecProtocol.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <unistd.h>
+
+static void put_be(uint8_t* p, uint64_t v, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) p[i] = static_cast<uint8_t>(v >> (8 * (n - 1 - i)));
+}
+
+static uint64_t get_be(const uint8_t* p, size_t n)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+// EINTR / 부분 write를 처리하며 len 바이트를 모두 씀
+static bool write_all(int fd, const uint8_t* data, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool read_all(int fd, uint8_t* data, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = ::read(fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void encode_params(const EncodeParams& params, uint8_t* out)
+{
+    put_be(out, params.symbol_size, 2);
+    put_be(out + 2, params.min_blocks, 2);
+    put_be(out + 4, static_cast<uint32_t>(std::lround(std::max(params.overhead_ratio, 0.0) * 100.0)), 4);
+    out[8] = params.flags;
+}
+
+EncodeParams parse_encode_params(const uint8_t* in)
+{
+    EncodeParams params;
+    params.symbol_size = static_cast<uint16_t>(get_be(in, 2));
+    params.min_blocks = static_cast<uint16_t>(get_be(in + 2, 2));
+    params.overhead_ratio = get_be(in + 4, 4) / 100.0;
+    params.flags = in[8];
+    return params;
+}
+
+bool CodecWriter::send(CodecMsg type, const uint8_t* body, size_t len)
+{
+    uint8_t header[CODEC_HEADER_SIZE];
+    header[0] = static_cast<uint8_t>(type);
+    put_be(header + 1, len, 4);
+    _buffer.insert(_buffer.end(), header, header + CODEC_HEADER_SIZE);
+
+    // 큰 body(DATA 등)는 버퍼에 복사하지 않고 바로 씀
+    if (len >= _flush_bytes) return flush() && write_all(_fd, body, len);
+    _buffer.insert(_buffer.end(), body, body + len);
+    return _buffer.size() < _flush_bytes || flush();
+}
+
+bool CodecWriter::flush()
+{
+    bool ok = write_all(_fd, _buffer.data(), _buffer.size());
+    _buffer.clear();
+    return ok;
+}
+
+bool read_codec_message(int fd, CodecMsg& type, std::vector<uint8_t>& body)
+{
+    uint8_t header[CODEC_HEADER_SIZE];
+    if (!read_all(fd, header, CODEC_HEADER_SIZE)) return false;
+    uint32_t len = static_cast<uint32_t>(get_be(header + 1, 4));
+    if (len > CODEC_MAX_MESSAGE) return false;
+    type = static_cast<CodecMsg>(header[0]);
+    body.resize(len);
+    return read_all(fd, body.data(), len);
+}
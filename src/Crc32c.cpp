@@ -0,0 +1,151 @@
+#include "Crc32c.hpp"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CRC32C_HW_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define CRC32C_HW_ARM 1
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+typedef uint32_t (*CrcKernel)(uint32_t crc, const uint8_t* data, size_t len);
+
+// ===================================================================
+// Table fallback (slicing-by-8: 8 bytes씩 table 8개로 처리)
+// ===================================================================
+struct CrcTables {
+    uint32_t t[8][256];
+
+    CrcTables()
+    {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : (c >> 1);
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int s = 1; s < 8; ++s) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+        }
+    }
+};
+
+static const CrcTables& tables()
+{
+    static const CrcTables tbl;
+    return tbl;
+}
+
+static uint32_t crc_table(uint32_t crc, const uint8_t* p, size_t len)
+{
+    const CrcTables& tbl = tables();
+    while (len >= 8) {
+        uint32_t lo = crc ^ (static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                             (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24));
+        crc = tbl.t[7][lo & 0xFF] ^ tbl.t[6][(lo >> 8) & 0xFF] ^ tbl.t[5][(lo >> 16) & 0xFF] ^ tbl.t[4][lo >> 24] ^
+              tbl.t[3][p[4]] ^ tbl.t[2][p[5]] ^ tbl.t[1][p[6]] ^ tbl.t[0][p[7]];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = (crc >> 8) ^ tbl.t[0][(crc ^ *p++) & 0xFF];
+    return crc;
+}
+
+// ===================================================================
+// x86 SSE4.2
+// ===================================================================
+#if defined(CRC32C_HW_X86)
+__attribute__((target("sse4.2")))
+static uint32_t crc_sse42(uint32_t crc, const uint8_t* p, size_t len)
+{
+#if defined(__x86_64__)
+    uint64_t c = crc;
+    while (len >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        len -= 8;
+    }
+    crc = static_cast<uint32_t>(c);
+#endif
+    while (len >= 4) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        len -= 4;
+    }
+    while (len--) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+#endif  // CRC32C_HW_X86
+
+// ===================================================================
+// aarch64 ARMv8 CRC32 extension
+// ===================================================================
+#if defined(CRC32C_HW_ARM)
+__attribute__((target("+crc")))
+static uint32_t crc_armv8(uint32_t crc, const uint8_t* p, size_t len)
+{
+    while (len >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = __crc32cb(crc, *p++);
+    return crc;
+}
+#endif  // CRC32C_HW_ARM
+
+// ===================================================================
+// Runtime dispatch (FEC_CRC32C_KERNEL=table 로 강제 가능, 벤치마크 비교용)
+// ===================================================================
+struct CrcKernelInfo {
+    const char* name;
+    CrcKernel fn;
+};
+
+static CrcKernelInfo select_kernel()
+{
+    CrcKernelInfo k = { "table", crc_table };
+    const char* force = std::getenv("FEC_CRC32C_KERNEL");
+    if (force && std::strcmp(force, "table") == 0) return k;
+
+#if defined(CRC32C_HW_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        k.name = "sse4.2"; k.fn = crc_sse42;
+    }
+#elif defined(CRC32C_HW_ARM)
+#if defined(HWCAP_CRC32)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+        k.name = "armv8"; k.fn = crc_armv8;
+    }
+#elif defined(__ARM_FEATURE_CRC32)
+    k.name = "armv8"; k.fn = crc_armv8;
+#endif
+#endif
+    return k;
+}
+
+static const CrcKernelInfo& kernel()
+{
+    static const CrcKernelInfo k = select_kernel();
+    return k;
+}
+
+const char* crc32c_kernel_name()
+{
+    return kernel().name;
+}
+
+uint32_t crc32c(const uint8_t* data, size_t len, uint32_t crc)
+{
+    return ~kernel().fn(~crc, data, len);
+}
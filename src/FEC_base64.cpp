@@ -6,8 +6,18 @@
 #include <RaptorQ/RaptorQ_v1_hdr.hpp>       // RaptorQ Library
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
+#include <memory>
 
 #include "base64.h"
+#include "Base64Simd.hpp"
+#include "FecBlocks.hpp"
+#include "LossEstimator.hpp"
+#include "MatrixCache.hpp"
+#include "PacketContainer.hpp"
+#include "Packetizer.hpp"
+#include "TransferMeta.hpp"
+#include "XxHash64.hpp"
 
 void print_hex(const std::string& title, const std::vector<uint8_t>& data)
 {
@@ -22,12 +32,12 @@ void print_hex(const std::string& title, const std::vector<uint8_t>& data)
     std::cout << std::endl << std::endl; 
 }
 
-int main()
+int main(int argc, char* argv[])
 {
     std::cout << "--- [TEST 1: CORRECT] Encoding(ID + Payload) to File  ---" << std::endl;
 
-    // Encoded Data File Create
-    const std::string output_filename = "../data/encoded_correct.txt";
+    // Encoded Data File Create (텍스트 / --format bin 이면 바이너리 컨테이너)
+    std::string output_filename = "../data/encoded_correct.txt";
 
     // step1: File Input
     const std::string filename = "../data/sample_data.txt";
@@ -47,36 +57,143 @@ int main()
     // Step2: RaptorQ Encoder
 
     uint16_t symbol_size = 32;
-    const double overhead_ratio = 10.0;
-    namespace RaptorQ = RaptorQ__v1;
-    using namespace RaptorQ;
-
-    // Encoder Templet에서 사용할 iterator type정의
-    using InputIt = std::vector<uint8_t>::iterator;
-    using OutputIt = std::vector<uint8_t>::iterator;
-    using Encoder = RaptorQ::Encoder<InputIt, OutputIt>;
-
-    // Block_Size Calculation
-    uint32_t min_symbol = (source_data.size() + symbol_size - 1) / symbol_size;
-    Block_Size block = Block_Size::Block_10;
-    for(auto blk : *blocks) {
-        if (static_cast<uint16_t>(blk) >= min_symbol){
-            block = blk;
-            break;
+    double overhead_ratio = -1.0;   // --overhead P 로 고정, 없으면 손실률 추정치로 선택
+
+    // 옵션: --blocks N (multi-block 모드, 최소 N개의 source block)
+    //       --address N / --target P (목적지 손실률 추정치로 성공 확률 P(기본 0.999)가 되는 repair 수 선택)
+    //       --overhead P (고정 overhead %, 추정치 무시) / --estimator FILE (기본 ../data/loss_estimate.txt)
+    //       --threads N (인코딩 worker thread 수, 기본값: 전체 코어)
+    //       --format txt|bin (bin: ../data/encoded_correct.fecb 바이너리 컨테이너)
+    //       --mtu N (AT+SEND 최대 문자 수, airtime이 최소가 되는 T와 프레임당 심볼 수를 선택)
+    //       --id full|compact (compact: 1~3 bytes varint Payload ID, 텍스트 패킷 모드 전용)
+    //       --check none|crc32c (crc32c: 패킷마다 CRC32C 4 bytes, --mtu 프레임 제외)
+    //       --matrix-cache DIR|none (K별 repair 계수 cache, 기본 ../data/matrix_cache)
+    uint32_t min_blocks = 1;
+    unsigned num_threads = 0;
+    bool binary_output = false;
+    size_t mtu = 0;
+    PacketFormat format;
+    int address = 0;
+    double target = DEFAULT_TARGET_SUCCESS;
+    std::string estimator_path = DEFAULT_LOSS_ESTIMATE_FILE;
+    std::string matrix_cache_dir = DEFAULT_MATRIX_CACHE_DIR;
+    for (int i = 1; i < argc; i += 2) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) opt.clear();
+        if (opt == "--blocks") min_blocks = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--threads") num_threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+        else if (opt == "--mtu") mtu = static_cast<size_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--address") address = std::stoi(argv[i + 1]);
+        else if (opt == "--target") target = std::stod(argv[i + 1]);
+        else if (opt == "--overhead") overhead_ratio = std::stod(argv[i + 1]);
+        else if (opt == "--estimator") estimator_path = argv[i + 1];
+        else if (opt == "--matrix-cache") matrix_cache_dir = argv[i + 1];
+        else if (opt == "--format" && (std::string(argv[i + 1]) == "txt" || std::string(argv[i + 1]) == "bin")) {
+            binary_output = (std::string(argv[i + 1]) == "bin");
+        }
+        else if (opt == "--id" && (std::string(argv[i + 1]) == "full" || std::string(argv[i + 1]) == "compact")) {
+            format.compact_id = (std::string(argv[i + 1]) == "compact");
+        }
+        else if (opt == "--check" && (std::string(argv[i + 1]) == "none" || std::string(argv[i + 1]) == "crc32c")) {
+            format.crc = (std::string(argv[i + 1]) == "crc32c");
+        }
+        else {
+            std::cerr << "Usage: ./FEC_base64 [--blocks N] [--threads N] [--format txt|bin] [--mtu N] [--id full|compact]" << std::endl;
+            std::cerr << "                    [--check none|crc32c] [--matrix-cache DIR|none]" << std::endl;
+            std::cerr << "                    [--address N] [--target P] [--overhead P] [--estimator FILE]" << std::endl;
+            return 1;
         }
     }
-    uint32_t num_source_symbols = static_cast<uint32_t>(block);
+    // 프레임 헤더와 컨테이너 레코드는 고정 4-byte ID를 유지, 프레임에는 CRC trailer 없음
+    if (format.compact_id && (mtu > 0 || binary_output)) {
+        std::cerr << "Error: --id compact cannot be combined with --mtu or --format bin" << std::endl;
+        return 1;
+    }
+    if (format.crc && mtu > 0) {
+        std::cerr << "Error: --check crc32c cannot be combined with --mtu" << std::endl;
+        return 1;
+    }
 
-    Encoder encoder(block, symbol_size);
+    // Adaptive overhead: --overhead가 없으면 목적지 손실률 추정치로 repair 수 선택
+    //  (MTU packing은 T가 바뀌므로 packing 후 최종 T로 다시 계산)
+    const bool adaptive = overhead_ratio < 0;
+    if (adaptive) {
+        overhead_ratio = adaptive_overhead_ratio(estimator_path, address, source_data.size(), symbol_size, min_blocks, target, mtu == 0);
+    }
+
+    // MTU 기반 packing: 프레임 하나에 n개의 심볼 (n은 각 프레임 첫 바이트에 기록)
+    uint8_t symbols_per_frame = 1;
+    if (mtu > 0) {
+        Packing packing = choose_packing(source_data.size(), overhead_ratio, mtu, LoRaParams(), min_blocks);
+        if (packing.symbols_per_frame == 0) {
+            std::cerr << "Error: MTU " << mtu << " is too small for a frame" << std::endl;
+            return 1;
+        }
+        symbol_size = packing.symbol_size;
+        symbols_per_frame = packing.symbols_per_frame;
+        std::cout << "MTU " << mtu << ": symbol size " << symbol_size << ", " << static_cast<int>(symbols_per_frame)
+                  << " symbol(s)/frame, " << packing.frames << " frames, airtime " << packing.airtime_ms << " ms" << std::endl;
+        if (adaptive) {
+            overhead_ratio = adaptive_overhead_ratio(estimator_path, address, source_data.size(), symbol_size, min_blocks, target, true);
+        }
+    }
 
-    encoder.set_data(source_data.begin(), source_data.end());
-    if (!encoder.compute_sync()){
-        std::cerr << "Encoder pre-computation failed" << std::endl;
+    // Source Block 분할 (한 Block_Size에 들어가면 기존과 같은 단일 블록)
+    std::vector<SourceBlock> blocks = partition_source_blocks(source_data.size(), symbol_size, min_blocks);
+    if (blocks.empty()) {
+        std::cerr << "Error: File too large (more than " << MAX_SOURCE_BLOCKS << " source blocks)" << std::endl;
         return 1;
     }
 
-    uint32_t num_repair_symbols = static_cast<uint32_t>(ceil(num_source_symbols * (overhead_ratio / 100.0)));
-    uint32_t total_symbols_to_send = num_source_symbols + num_repair_symbols;
+    // 블록마다 worker thread에서 compute_sync + 심볼 생성 (cache된 K는 compute_sync 생략)
+    std::unique_ptr<MatrixCache> matrix_cache;
+    if (matrix_cache_dir != "none") matrix_cache.reset(new MatrixCache(matrix_cache_dir));
+    std::vector<EncodedBlock> encoded = encode_blocks_parallel(source_data, blocks, symbol_size,
+                                                               overhead_ratio, num_threads, matrix_cache.get());
+    if (matrix_cache) std::cout << "Matrix cache (" << matrix_cache_dir << "): " << matrix_cache->summary() << std::endl;
+
+    uint32_t total_symbols_to_send = 0;
+    for (const auto& eb : encoded) {
+        if (!eb.ok) {
+            std::cerr << "Encoder pre-computation failed (SBN " << static_cast<int>(eb.sbn) << ")" << std::endl;
+            return 1;
+        }
+        total_symbols_to_send += eb.num_packets;
+    }
+
+    // [SBN 1바이트 | ESI 3바이트] + [페이로드] 패킷은 encode_blocks_parallel에서 이미 결합됨
+    const size_t packet_size = PAYLOAD_ID_SIZE + symbol_size;
+
+    // 바이너리 컨테이너: 레코드를 그대로 기록 (Base64 변환 없음)
+    if (binary_output) {
+        output_filename = "../data/encoded_correct.fecb";
+        ContainerHeader header;
+        header.symbol_size = symbol_size;
+        header.transfer_length = source_data.size();
+        header.has_hash = true;
+        header.content_hash = xxh64(source_data.data(), source_data.size());
+        header.num_source_symbols = static_cast<uint32_t>(blocks[0].block);
+        header.num_blocks = static_cast<uint16_t>(blocks.size());
+        header.record_size = static_cast<uint16_t>(packet_size + (format.crc ? PACKET_CRC_SIZE : 0));
+
+        ContainerWriter writer;
+        if (!writer.open(output_filename, header)) {
+            std::cerr << "Error: Cannot open file" << output_filename << std::endl;
+            return 1;
+        }
+        std::vector<uint8_t> record(packet_buffer_size(symbol_size));
+        for (const auto& eb : encoded) {
+            for (uint32_t i = 0; i < eb.num_packets; ++i) {
+                writer.append(record.data(), format_packet(eb.packets.data() + i * packet_size, symbol_size, format, record.data()));
+            }
+        }
+        if (!writer.close()) {
+            std::cerr << "Error: Cannot write file" << output_filename << std::endl;
+            return 1;
+        }
+        std::cout << "Saved " << total_symbols_to_send << " records to " << output_filename << std::endl;
+        return 0;
+    }
 
     // File Output Stream
     std::ofstream output_file(output_filename);
@@ -85,44 +202,55 @@ int main()
 	return 1;
     }
 
-    std::cout << "Saving " << total_symbols_to_send << " (ID+Payload) packets to " << output_filename << "..." << std::endl;
-
-    auto src_it = encoder.begin_source();
-    auto repair_it = encoder.begin_repair();
+    std::cout << "Saving " << total_symbols_to_send << " (ID+Payload) packets in " << blocks.size()
+              << " block(s) to " << output_filename << "..." << std::endl;
 
-    for (uint32_t i=0; i < total_symbols_to_send; ++i){
+    std::vector<char> line_buf(base64_encoded_size(std::max<size_t>({ FRAME_HEADER_SIZE + symbols_per_frame * symbol_size,
+                                                                      packet_buffer_size(symbol_size), META_RECORD_SIZE })));  // Base64 한 줄 버퍼 (재사용)
+    size_t line_len = 0;
+    auto write_line = [&](const uint8_t* data, size_t size) {
+        base64_encode_to(data, size, line_buf.data(), line_buf.size(), line_len);
+        output_file.write(line_buf.data(), line_len) << "\n";
+        return static_cast<bool>(output_file);
+    };
 
-	uint32_t current_id;
-	std::vector<uint8_t> payload(symbol_size);
-	auto out_it = payload.begin();
+    // 처음, META_REPEAT_INTERVAL개의 데이터 줄마다, 끝에 metadata record
+    //  (OTI: F / T / Z / K / transfer ID + 원본 xxHash64 -> 디코더가 하드코딩 없이 Decoder 생성 / 결과 확인)
+    TransferMeta meta = make_transfer_meta(source_data.size(), symbol_size, static_cast<uint16_t>(blocks.size()),
+                                           static_cast<uint16_t>(blocks[0].block), true,
+                                           xxh64(source_data.data(), source_data.size()));
+    uint8_t meta_record[META_RECORD_SIZE];
+    encode_transfer_meta(meta, meta_record);
+    write_line(meta_record, META_RECORD_SIZE);
+    uint32_t data_lines = 0;
+    auto write_data_line = [&](const uint8_t* data, size_t size) {
+        if (!write_line(data, size)) return false;
+        return ++data_lines % META_REPEAT_INTERVAL != 0 || write_line(meta_record, META_RECORD_SIZE);
+    };
 
-	if(i < num_source_symbols){
-		current_id = (*src_it).id();
-		(*src_it)(out_it, payload.end());
-		++src_it;
-	}
-	else {
-		current_id = (*repair_it).id();
-		(*repair_it)(out_it, payload.end());
-		++repair_it;
-	}
-
-
-	// [ID 4바이트] + [페이로드] 결합
-        uint8_t id_bytes[4];
-        id_bytes[0] = (current_id >> 24) & 0xFF;
-        id_bytes[1] = (current_id >> 16) & 0xFF;
-        id_bytes[2] = (current_id >> 8) & 0xFF;
-        id_bytes[3] = (current_id >> 0) & 0xFF;
-        std::vector<uint8_t> final_packet;
-        final_packet.insert(final_packet.end(), id_bytes, id_bytes + 4);
-        final_packet.insert(final_packet.end(), payload.begin(), payload.end());
-
-	std::string base64_output = base64_encode(final_packet.data(), final_packet.size());
-
-	output_file << base64_output << "\n";
+    if (mtu > 0) {
+        // 프레임 단위 ([n | SBN | ESI] + n개의 심볼)
+        Packetizer packetizer(symbol_size, symbols_per_frame, write_data_line);
+        for (const auto& eb : encoded) {
+            for (uint32_t i = 0; i < eb.num_packets; ++i) packetizer.add(eb.packets.data() + i * packet_size);
+            packetizer.flush();
+        }
+    } else if (format.compact_id || format.crc) {
+        // [varint ID 1~3B 또는 4B ID | symbol | (CRC32C)] (블록 수로 SBN bit 수 결정)
+        format.sbn_bits = sbn_bits_for(blocks.size());
+        std::vector<uint8_t> formatted(packet_buffer_size(symbol_size));
+        for (const auto& eb : encoded) {
+            for (uint32_t i = 0; i < eb.num_packets; ++i) {
+                write_data_line(formatted.data(), format_packet(eb.packets.data() + i * packet_size, symbol_size, format, formatted.data()));
+            }
+        }
+    } else {
+        for (const auto& eb : encoded) {
+            for (uint32_t i = 0; i < eb.num_packets; ++i) write_data_line(eb.packets.data() + i * packet_size, packet_size);
+        }
     }
 
+    if (data_lines % META_REPEAT_INTERVAL != 0) write_line(meta_record, META_RECORD_SIZE);
     output_file.close();
     std::cout << "File saved successfully" << std::endl;
 
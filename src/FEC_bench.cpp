@@ -0,0 +1,285 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <memory>
+#include <RaptorQ/RaptorQ_v1_hdr.hpp>       // RaptorQ Library
+
+#include "FecBlocks.hpp"
+#include "ThreadPool.hpp"
+
+// --- Monte Carlo erasure-channel benchmark ---
+//  - (K, symbol_size, overhead) 조합마다 인코더 결과를 한 번 만들고
+//  - 손실 채널을 여러 번(trials) 통과시켜 디코딩 성공률, 필요한 심볼 수, wait_sync() 시간을 측정
+//  - trial은 ThreadPool에서 병렬로 실행 (trial마다 seed 고정 -> 결과 재현 가능)
+
+namespace RaptorQ = RaptorQ__v1;
+
+// ==========================================================
+// Erasure models
+// ==========================================================
+struct ErasureModel {
+    bool gilbert_elliott = false;
+    double loss = 0.1;          // Bernoulli: 패킷별 독립 손실 확률
+    double p_good_to_bad = 0.0; // Gilbert-Elliott 상태 전이 확률
+    double p_bad_to_good = 0.0;
+    double loss_good = 0.0;     // 상태별 손실 확률
+    double loss_bad = 1.0;
+
+    std::string describe() const
+    {
+        std::ostringstream os;
+        if (gilbert_elliott) {
+            os << "Gilbert-Elliott (p_gb=" << p_good_to_bad << ", p_bg=" << p_bad_to_good
+               << ", loss_good=" << loss_good << ", loss_bad=" << loss_bad << ")";
+        } else {
+            os << "Bernoulli (loss=" << loss << ")";
+        }
+        return os.str();
+    }
+};
+
+class ErasureChannel {
+public:
+    ErasureChannel(const ErasureModel& model, uint32_t seed) : _model(model), _rng(seed) {}
+
+    // 다음 패킷이 손실되면 true
+    bool drop()
+    {
+        if (!_model.gilbert_elliott) return _uniform(_rng) < _model.loss;
+        bool lost = _uniform(_rng) < (_bad ? _model.loss_bad : _model.loss_good);
+        double flip = _bad ? _model.p_bad_to_good : _model.p_good_to_bad;
+        if (_uniform(_rng) < flip) _bad = !_bad;
+        return lost;
+    }
+
+private:
+    const ErasureModel& _model;
+    std::mt19937 _rng;
+    std::uniform_real_distribution<double> _uniform{0.0, 1.0};
+    bool _bad = false;
+};
+
+// ==========================================================
+// Single trial
+// ==========================================================
+struct TrialResult {
+    bool ready = false;         // K개 이상의 심볼을 받았는지
+    bool success = false;       // 받은 심볼의 어떤 prefix로든 wait_sync() 성공 + 원본과 일치
+    uint32_t symbols_needed = 0; // 처음 복원에 성공했을 때까지 받은 심볼 수
+    double wait_us = 0.0;       // wait_sync() 시간 합 (rank 부족으로 다시 시도한 것 포함)
+};
+
+static TrialResult run_trial(const EncodedBlock& eb, const SourceBlock& sb, uint16_t symbol_size,
+                             const std::vector<uint8_t>& source, const ErasureModel& model, uint32_t seed)
+{
+    using InputIt = const uint8_t*;
+    using OutputIt = std::vector<uint8_t>::iterator;
+    using Decoder = RaptorQ::Decoder<InputIt, OutputIt>;
+
+    TrialResult result;
+    ErasureChannel channel(model, seed);
+    std::unique_ptr<Decoder> decoder(new Decoder(sb.block, symbol_size, Decoder::Report::COMPLETE));
+    const size_t packet_size = PAYLOAD_ID_SIZE + symbol_size;
+    auto add = [&](const uint8_t* packet) {
+        uint8_t sbn;
+        uint32_t esi;
+        read_payload_id(packet, sbn, esi);
+        const uint8_t* payload = packet + PAYLOAD_ID_SIZE;
+        return decoder->add_symbol(payload, packet + packet_size, esi) == RaptorQ::Error::NONE;
+    };
+
+    // 송신 순서(source -> repair)대로 채널 통과, ready가 된 뒤에는 심볼이 하나 늘 때마다 복원 시도
+    //  - K개만으로 rank가 부족한 경우가 있음 -> 실패해도 남은 심볼을 계속 넣어 (rateless 수신과 같음)
+    //    처음 성공한 prefix의 길이를 symbols_needed로 기록
+    std::vector<const uint8_t*> received;
+    for (uint32_t i = 0; i < eb.num_packets; ++i) {
+        if (channel.drop()) continue;
+        const uint8_t* packet = eb.packets.data() + i * packet_size;
+        if (!add(packet)) continue;
+        received.push_back(packet);
+        if (!decoder->ready()) continue;
+        result.ready = true;
+
+        auto start = std::chrono::steady_clock::now();
+        decoder->end_of_input(RaptorQ::Fill_With_Zeros::NO);
+        auto res = decoder->wait_sync();
+        result.wait_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if (res.error == RaptorQ::Error::NONE) {
+            result.symbols_needed = static_cast<uint32_t>(received.size());
+            std::vector<uint8_t> decoded(sb.length);
+            auto out_it = decoded.begin();
+            auto written = decoder->decode_bytes(out_it, decoded.end(), 0, 0);
+            result.success = written.written == sb.length &&
+                             std::equal(decoded.begin(), decoded.end(), source.begin() + sb.offset);
+            return result;
+        }
+        // end_of_input() 이후에는 심볼을 더 넣을 수 없음 -> 받은 심볼로 새 Decoder
+        decoder.reset(new Decoder(sb.block, symbol_size, Decoder::Report::COMPLETE));
+        for (const uint8_t* p : received) add(p);
+    }
+    return result;
+}
+
+// ==========================================================
+// Helpers
+// ==========================================================
+template <typename T>
+static std::vector<T> parse_list(const std::string& text)
+{
+    std::vector<T> values;
+    std::istringstream is(text);
+    std::string item;
+    while (std::getline(is, item, ',')) {
+        if (item.empty()) continue;
+        std::istringstream conv(item);
+        T v;
+        conv >> v;
+        values.push_back(v);
+    }
+    return values;
+}
+
+template <typename T>
+static T percentile(std::vector<T>& sorted, double p)
+{
+    if (sorted.empty()) return T();
+    size_t idx = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+int main(int argc, char* argv[])
+{
+    // ==========================================================
+    // A: Options
+    // ==========================================================
+    std::vector<uint32_t> k_list = { 26, 100, 500 };
+    std::vector<uint16_t> t_list = { 32 };
+    std::vector<double> overhead_list = { 5, 10, 20, 30, 50 };  // overhead_ratio (%)
+    ErasureModel model;
+    uint32_t trials = 1000;
+    unsigned num_threads = 0;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; i += 2) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) opt.clear();
+        if (opt == "--k") k_list = parse_list<uint32_t>(argv[i + 1]);
+        else if (opt == "--symbol-size") t_list = parse_list<uint16_t>(argv[i + 1]);
+        else if (opt == "--overhead") overhead_list = parse_list<double>(argv[i + 1]);
+        else if (opt == "--loss") model.loss = std::stod(argv[i + 1]);
+        else if (opt == "--ge") {
+            std::vector<double> ge = parse_list<double>(argv[i + 1]);
+            if (ge.size() != 4) {
+                std::cerr << "[ERROR] --ge needs p_gb,p_bg,loss_good,loss_bad" << std::endl;
+                return 1;
+            }
+            model.gilbert_elliott = true;
+            model.p_good_to_bad = ge[0];
+            model.p_bad_to_good = ge[1];
+            model.loss_good = ge[2];
+            model.loss_bad = ge[3];
+        }
+        else if (opt == "--trials") trials = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--threads") num_threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+        else if (opt == "--seed") seed = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else {
+            std::cout << "[Error] Usage: ./FEC_bench [--k 26,100,500] [--symbol-size 32] [--overhead 5,10,20]" << std::endl;
+            std::cout << "                   [--loss P | --ge p_gb,p_bg,loss_good,loss_bad] [--trials N] [--threads N] [--seed N]" << std::endl;
+            std::cout << "  Example: ./FEC_bench --k 26,100 --overhead 10,30 --ge 0.05,0.3,0.01,0.8 --trials 5000" << std::endl;
+            return 1;
+        }
+    }
+    if (k_list.empty() || t_list.empty() || overhead_list.empty() || trials == 0) {
+        std::cerr << "[ERROR] Empty parameter list" << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool(num_threads);
+    std::cout << "--- FEC erasure-channel benchmark ---" << std::endl;
+    std::cout << " Channel: " << model.describe() << std::endl;
+    std::cout << " Trials: " << trials << " per combination, threads: " << pool.size() << std::endl << std::endl;
+    std::cout << std::left << std::setw(7) << "K" << std::setw(6) << "T" << std::setw(10) << "overhead"
+              << std::setw(8) << "repair" << std::setw(10) << "success"
+              << std::setw(22) << "needed mean/p50/p99" << "wait_sync us p50/p90/p99" << std::endl;
+
+    std::mt19937 data_rng(seed);
+    for (uint16_t symbol_size : t_list) {
+        for (uint32_t k : k_list) {
+            // ==========================================================
+            // B: Source data + block (한 블록만 사용)
+            // ==========================================================
+            std::vector<uint8_t> source(static_cast<size_t>(k) * symbol_size);
+            for (auto& b : source) b = static_cast<uint8_t>(data_rng());
+            std::vector<SourceBlock> blocks = partition_source_blocks(source.size(), symbol_size);
+            if (blocks.size() != 1) {
+                std::cerr << "[Warning] K=" << k << " does not fit in one source block. Skipping." << std::endl;
+                continue;
+            }
+            const SourceBlock& sb = blocks[0];
+
+            for (double overhead : overhead_list) {
+                // ==========================================================
+                // C: Encode once, run trials on the pool
+                // ==========================================================
+                std::vector<EncodedBlock> encoded = encode_blocks_parallel(source, blocks, symbol_size, overhead, 1);
+                if (!encoded[0].ok) {
+                    std::cerr << "Encoder pre-computation failed (K=" << k << ")" << std::endl;
+                    return 1;
+                }
+                const EncodedBlock& eb = encoded[0];
+
+                std::vector<TrialResult> results(trials);
+                const uint32_t chunk = std::max<uint32_t>(1, trials / static_cast<uint32_t>(pool.size() * 4));
+                std::vector<std::future<void>> jobs;
+                for (uint32_t first = 0; first < trials; first += chunk) {
+                    uint32_t last = std::min(trials, first + chunk);
+                    jobs.push_back(pool.submit([&, first, last]() {
+                        for (uint32_t t = first; t < last; ++t) {
+                            results[t] = run_trial(eb, sb, symbol_size, source, model, seed * 1000003u + t);
+                        }
+                    }));
+                }
+                for (auto& job : jobs) job.get();
+
+                // ==========================================================
+                // D: Report
+                // ==========================================================
+                uint32_t successes = 0;
+                std::vector<uint32_t> needed;
+                std::vector<double> wait_us;
+                double needed_sum = 0.0;
+                for (const auto& r : results) {
+                    if (r.ready) wait_us.push_back(r.wait_us);
+                    if (r.success) {
+                        successes++;
+                        needed.push_back(r.symbols_needed);
+                        needed_sum += r.symbols_needed;
+                    }
+                }
+                std::sort(needed.begin(), needed.end());
+                std::sort(wait_us.begin(), wait_us.end());
+
+                std::ostringstream overhead_col, success_col, needed_col, wait_col;
+                overhead_col << overhead << "%";
+                success_col << std::fixed << std::setprecision(2) << (100.0 * successes / trials) << "%";
+                if (needed.empty()) needed_col << "-";
+                else needed_col << std::fixed << std::setprecision(1) << (needed_sum / needed.size()) << "/"
+                                << percentile(needed, 0.5) << "/" << percentile(needed, 0.99);
+                if (wait_us.empty()) wait_col << "-";
+                else wait_col << std::fixed << std::setprecision(0) << percentile(wait_us, 0.5) << "/"
+                              << percentile(wait_us, 0.9) << "/" << percentile(wait_us, 0.99);
+
+                std::cout << std::left << std::setw(7) << static_cast<uint32_t>(sb.block) << std::setw(6) << symbol_size
+                          << std::setw(10) << overhead_col.str() << std::setw(8) << (eb.num_packets - eb.num_source_symbols)
+                          << std::setw(10) << success_col.str() << std::setw(22) << needed_col.str() << wait_col.str() << std::endl;
+            }
+        }
+    }
+
+    return 0;
+}
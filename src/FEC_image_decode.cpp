@@ -3,33 +3,93 @@
 #include <vector>
 #include <string>
 #include <iterator>
-#include <RaptorQ/RaptorQ_v1_hdr.hpp> // RaptorQ Library
 #include <cstdio>
 #include <cmath>
-#include <stdexcept>    // ⬅️ Base64 에러 처리를 위해 추가
+#include <iomanip>
 
 // ⬅️ Base64 디코딩을 위해 헤더 포함
 #include "base64.h"
+#include "Base64Simd.hpp"
+#include "FecDecoder.hpp"
+#include "ProgressiveFile.hpp"
+#include "PacketContainer.hpp"
+#include "Packetizer.hpp"
+#include "TransferMeta.hpp"
 
 int main(int argc, char* argv[])
 {
     // ==========================================================
     // A: File Setup
     // ==========================================================
-    if (argc != 2){
-        std::cout << "[Error] Usage: ./decoder_image <input_file>" << std::endl;
+    if (argc < 2){
+        std::cout << "[Error] Usage: ./decoder_image <input_file> [--framed] [--size BYTES] [--symbol-size N] [--blocks N]" << std::endl;
         std::cout << "  Example: ./decoder_image ../data/encoded_image_correct.txt" << std::endl;
         return 1;
     }
     
     const std::string input_filename = argv[1];
     const std::string output_filename = "../data/decoded_image_result.jpg"; 
-    const uint16_t symbol_size = 32;
 
-    // A-1: (임시) 원본 파일 크기를 알아야 함
-    //      (가장 좋은 방법은 이 값을 인코더에서 파일로 저장하고,
-    //       디코더가 읽어오는 것이지만, 지금은 하드코딩합니다.)
-    const uint32_t total_data_size = 1018; // (1018 바이트)
+    // A-0: --mtu로 인코딩한 파일(한 줄 = 프레임)은 --framed
+    //      --size / --symbol-size / --blocks: metadata record가 없는 (이전 인코더의) 파일용, 인코더와 같은 값
+    uint64_t size_option = 0;
+    uint16_t symbol_size = 32;
+    uint32_t min_blocks = 1;
+    bool framed = false;
+    bool symbol_size_given = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (opt == "--blocks" && i + 1 < argc) min_blocks = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (opt == "--size" && i + 1 < argc) size_option = std::stoull(argv[++i]);
+        else if (opt == "--symbol-size" && i + 1 < argc) {
+            symbol_size = static_cast<uint16_t>(std::stoul(argv[++i]));
+            symbol_size_given = true;
+        }
+        else if (opt == "--framed") framed = true;
+        else {
+            std::cerr << "[ERROR] Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // A-1: 원본 크기 / T / Z는 인코더가 보낸 OTI에서 가져옴 (하드코딩 없음)
+    //      - .fecb 컨테이너: 헤더
+    //      - 텍스트 파일: metadata record (처음 / 반복 / 끝 중 먼저 찾은 것, 첫 줄이 손실돼도 됨)
+    TransferMeta oti;
+    ContainerReader container;
+    const bool from_container = ContainerReader::isContainer(input_filename);
+    if (from_container) {
+        if (!container.open(input_filename)) {
+            std::cerr << "Error: Cannnot open input File " << input_filename << std::endl;
+            return 1;
+        }
+        const ContainerHeader& h = container.header();
+        oti = make_transfer_meta(h.transfer_length, h.symbol_size, h.num_blocks, static_cast<uint16_t>(h.num_source_symbols),
+                                 h.has_hash, h.content_hash);
+    } else if (!scan_transfer_meta(input_filename, oti) && size_option == 0) {
+        std::cerr << "[ERROR] No transfer metadata record in " << input_filename << ". Pass --size BYTES (and --symbol-size N, --blocks N)." << std::endl;
+        return 1;
+    }
+    uint64_t total_data_size = oti.transfer_length > 0 ? oti.transfer_length : size_option;
+
+    // A-2: OTI가 없는 프레임 파일은 첫 번째 정상 프레임에서 T를 알아냄 (T = (길이 - 5) / n)
+    if (oti.has_oti) {
+        symbol_size = oti.symbol_size;
+    } else if (framed && !symbol_size_given) {
+        std::ifstream peek_file(input_filename);
+        std::string line;
+        std::vector<uint8_t> frame(256);
+        size_t frame_len = 0;
+        FrameView fv;
+        while (std::getline(peek_file, line)) {
+            if (base64_decode_to(line.data(), line.size(), frame.data(), frame.size(), frame_len) == Base64Status::OK &&
+                parse_frame(frame.data(), frame_len, fv)) {
+                symbol_size = fv.symbol_size;
+                break;
+            }
+        }
+        std::cout << "  Framed input, symbol size: " << symbol_size << " bytes" << std::endl;
+    }
 
     std::cout << "--- " << input_filename << " File Decoding (Image)---" << std::endl;
     std::cout << "  Expecting original size: " << total_data_size << " bytes" << std::endl;
@@ -38,131 +98,140 @@ int main(int argc, char* argv[])
     // ==========================================================
     // B: RaptorQ Decoder Setup
     // ==========================================================
-    namespace RaptorQ = RaptorQ__v1;
-    using namespace RaptorQ;
-    using InputIt = std::vector<uint8_t>::iterator;
-    using OutputIt = std::vector<uint8_t>::iterator;
-    using Decoder = RaptorQ::Decoder<InputIt,OutputIt>;
-
     // B-1: Calculate minimum symbols (Encoder와 동일한 로직)
-    uint32_t min_symbol = (total_data_size + symbol_size - 1) / symbol_size;
-
-    // B-2: Find valid Block_Size (Encoder와 동일한 로직)
-    Block_Size block = Block_Size::Block_10; 
-    for(auto blk : *blocks) {
-        if (static_cast<uint16_t>(blk) >= min_symbol){
-            block = blk;
-            break;
-        }
+    uint64_t min_symbol = (total_data_size + symbol_size - 1) / symbol_size;
+
+    // B-2: Source block partition + one decoder per source block (SBN = index)
+    //      OTI가 있으면 record의 F / T / Z로 (분할 결과가 record의 K와 같은지 확인, hash도 등록)
+    //      source symbol은 도착하는 즉시 출력 버퍼에 복사 (FecDecoder의 systematic fast path)
+    FecDecoder fec = oti.has_oti ? FecDecoder(oti) : FecDecoder(total_data_size, symbol_size, min_blocks);
+    if (!fec.valid()) {
+        std::cerr << "[ERROR] Invalid source block partition" << std::endl;
+        return 1;
     }
-    // B-3: Actual source symbols (K) (Encoder와 동일한 로직)
-    uint32_t num_source_symbols = static_cast<uint32_t>(block);
-    
+    if (fec.hasTransferId()) std::cout << "  Transfer ID: " << fec.transferId() << " (from " << (from_container ? "container header" : "metadata record") << ")" << std::endl;
+
     std::cout << "  Min symbols needed: " << min_symbol << std::endl;
-    std::cout << "  Selected Block Size (K): " << num_source_symbols << std::endl;
-    
-    Decoder decoder(block, symbol_size, Decoder::Report::COMPLETE);
+    std::cout << "  Source blocks (Z): " << fec.blocks().size() << std::endl;
+    for (const auto& sb : fec.blocks()) {
+        std::cout << "  [SBN " << static_cast<int>(sb.sbn) << "] Block Size (K): " << static_cast<uint32_t>(sb.block) << std::endl;
+    }
+
+    // B-3: Progressive output - 도착한 source symbol은 바로 출력 파일의 제자리에 기록
+    //      (블록 디코딩은 빠진 구간만 채움, 실패해도 받은 부분은 파일에 남음)
+    ProgressiveFile out_file;
+    if (!out_file.open(output_filename, total_data_size)) return 1;
+    fec.setOutputSink([&](uint64_t offset, const uint8_t* data, size_t len) {
+        out_file.write(offset, data, len);
+    });
+    // B-4: 원본 hash는 OTI와 함께 등록됨 (v1 record / 컨테이너는 hash만, 텍스트 파일은 읽는 중에 metadata record 줄로)
+    if (!oti.has_oti && oti.has_hash) fec.setExpectedHash(oti.content_hash);
 
     // ==========================================================
     // C: Read File & Add Symbols
     // ==========================================================
-    std::ifstream input_file(input_filename);
-    if(!input_file){
-        std::cerr << "Error: Cannnot open input File " << input_filename << std::endl;
-        return 1; 
-    }
+    // C-0: 패킷/프레임 하나를 추가 (컨테이너 레코드도 같은 경로), 모든 블록이 ready가 되면 true
+    auto add = [&](const uint8_t* packet, size_t packet_len, const char* unit, uint32_t number) {
+        FecDecoder::AddResult r = framed ? fec.addFrame(packet, packet_len) : fec.addPacket(packet, packet_len);
+        if (r == FecDecoder::AddResult::BAD_SIZE) {
+            if (framed) {
+                std::cerr << "[Warning] " << unit << " " << number << ": Malformed frame (Size: " << packet_len << "). Ignoring." << std::endl;
+            } else {
+                std::cerr << "[Warning] " << unit << " " << number << ": Received packet with unexpected size (Size: "
+                          << packet_len << "). Expecting " << (1 + symbol_size) << "~" << (PAYLOAD_ID_SIZE + PACKET_CRC_SIZE + symbol_size) << " bytes. Ignoring." << std::endl;
+            }
+        } else if (r == FecDecoder::AddResult::BAD_CHECKSUM) {
+            std::cerr << "[Warning] " << unit << " " << number << ": CRC32C mismatch. Treating packet as lost." << std::endl;
+        } else if (r == FecDecoder::AddResult::UNKNOWN_BLOCK) {
+            std::cerr << "[Warning] " << unit << " " << number << ": Unknown source block. Ignoring." << std::endl;
+        } else if (r == FecDecoder::AddResult::ERROR) {
+            std::cerr << "[Warning] " << unit << " " << number << ": Error adding symbol" << std::endl;
+        }
+        return fec.ready();
+    };
+
+    // C-1: 모든 블록이 ready가 되면 바로 복원하고 content hash 확인, 더 읽을 필요가 없으면 true
+    //      hash 불일치: 행렬 디코딩한 블록을 다시 열고 남은 줄에서 심볼을 더 읽음 (틀린 파일로 끝내지 않음)
+    bool decode_failed = false;
+    auto finish = [&]() {
+        std::cout << ">>> Ready to decode after receiving " << fec.received() << " valid symbols." << std::endl;
+        // source symbol이 모두 도착한 블록은 이미 복원됨 -> 나머지 블록만 wait_sync()
+        size_t fast_blocks = fec.fastPathBlocks();
+        if (fast_blocks < fec.blocks().size()) std::cout << "Decoding (wait_sync)..." << std::endl;
+        std::cout << "  " << fast_blocks << "/" << fec.blocks().size() << " blocks complete from source symbols (no matrix decoding)" << std::endl;
+        if (!fec.decode()) {
+            // rank 부족으로 다시 연 블록 -> 남은 줄에서 심볼을 더 읽음
+            if (!fec.ready()) return false;
+            decode_failed = true;
+            return true;
+        }
+        if (fec.hashStatus() != FecDecoder::HashStatus::MISMATCH) return true;
+        uint64_t restored_hash = fec.contentHash();
+        size_t reopened = fec.reopenBlocks();
+        std::cerr << "[Warning] Content hash mismatch (xxHash64 " << std::hex << std::setw(16) << std::setfill('0') << restored_hash
+                  << std::dec << std::setfill(' ') << "). Reopened " << reopened << " block(s), reading more symbols." << std::endl;
+        return false;
+    };
 
-    std::string line; // Base64 문자열 한 줄
-    uint32_t received_count = 0;
-    uint32_t line_number = 0;
-    
     std::cout << "Reading packets from " << input_filename << "..." << std::endl;
-    while (std::getline(input_file, line)){
-        line_number++;
-        
-        try {
-            std::string decoded_str = base64_decode(line);
-            std::vector<uint8_t> received_packet(decoded_str.begin(), decoded_str.end());
-            
-            // C-1: Check packet size (ID + Payload)
-            if (received_packet.size() == (4 + symbol_size)) {
-                
-                // C-2: Parse ID
-                uint32_t symbol_id = (static_cast<uint32_t>(received_packet[0]) << 24) |
-                                     (static_cast<uint32_t>(received_packet[1]) << 16) |
-                                     (static_cast<uint32_t>(received_packet[2]) << 8)  |
-                                     (static_cast<uint32_t>(received_packet[3]));
-                
-                // C-3: Get payload data (after 4 bytes)
-                auto payload_start = received_packet.begin() + 4;
-                
-                // C-4: Add to decoder
-                auto err = decoder.add_symbol(payload_start, received_packet.end(), symbol_id);
-
-                if (err == RaptorQ::Error::NONE){
-                    received_count++;
-                } else if (err != RaptorQ::Error::NOT_NEEDED) {
-                    std::cerr << "[Warning] Line " << line_number << ": Error adding symbol ID " << symbol_id << std::endl;
-                }
-            } 
-            else {
-                 std::cerr << "[Warning] Line " << line_number << ": Received packet with unexpected size (Size: " 
-                           << received_packet.size() << "). Expecting 36 bytes. Ignoring." << std::endl;
-            }
-            
-            // C-5: Check if ready
-            if (decoder.ready()) {
-                std::cout << ">>> Ready to decode after receiving " << received_count << " valid symbols." << std::endl;
-                break;
+    if (from_container) {
+        // 컨테이너: 레코드를 복사 없이 바로 decoder에 넘김
+        for (size_t i = 0; i < container.size(); ++i) {
+            if (add(container.record(i), container.recordSize(), "Record", static_cast<uint32_t>(i + 1)) && finish()) break;
+        }
+        container.close();
+    } else {
+        std::ifstream input_file(input_filename);
+        if(!input_file){
+            std::cerr << "Error: Cannnot open input File " << input_filename << std::endl;
+            return 1;
+        }
+
+        std::string line; // Base64 문자열 한 줄
+        std::vector<uint8_t> received_packet(256); // 디코딩된 패킷 버퍼 (재사용, LoRa 최대 payload 이상)
+        uint32_t line_number = 0;
+
+        while (std::getline(input_file, line)){
+            line_number++;
+
+            // Base64 검증 + 디코딩 (예외 없음, 손상된 줄도 정상 줄과 같은 비용)
+            Base64DecodeResult b64 = base64_decode_checked(line.data(), line.size(), received_packet.data(), received_packet.size());
+            size_t packet_len = b64.written;
+            if (b64.status == Base64Status::OUTPUT_TOO_SMALL) {
+                packet_len = base64_decoded_max_size(line.size());   // 너무 긴 패킷 -> 크기 오류로 처리
+            } else if (b64.status != Base64Status::OK) {
+                std::cerr << "[Warning] Line " << line_number << ": Base64 decode failed at column " << (b64.error_offset + 1)
+                          << ". Packet corrupted." << std::endl;
+                continue;
             }
 
-        } catch (const std::exception& e) {
-            std::cerr << "[Warning] Line " << line_number << ": Base64 decode failed. Packet corrupted. (" << e.what() << ")" << std::endl;
+            if (add(received_packet.data(), packet_len, "Line", line_number) && finish()) break;
         }
+        input_file.close();
     }
-    input_file.close();
-    std::cout << "  Total valid symbols received: " << received_count << std::endl;
+    std::cout << "  Total valid symbols received: " << fec.received() << std::endl;
+    if (fec.checksumFailures() > 0) std::cout << "  CRC32C failures (dropped as erasures): " << fec.checksumFailures() << std::endl;
 
     // ==========================================================
-    // D: Decode (wait_sync & decode_bytes)
+    // D: Result (복원은 C-1에서 ready가 되는 즉시 실행)
     // ==========================================================
-    if (decoder.ready()){
-        std::cout << "Decoding (wait_sync)..." << std::endl;
-        std::vector<uint8_t> decoded_data(total_data_size);
-        auto out_it = decoded_data.begin();
-        
-        // D-1: Tell decoder no more symbols
-        decoder.end_of_input(RaptorQ::Fill_With_Zeros::NO);
-        // D-2: Run computation
-        auto res = decoder.wait_sync();
-
-        if (res.error != RaptorQ::Error::NONE){
-            std::cerr << "[FAILURE] Decode failed during wait_sync(). Error code: " << static_cast<int>(res.error) << std::endl;
-        }
-        else {
-            // D-3: Copy computed data to vector
-            size_t decoded_from_byte = 0;
-            size_t skip_bytes_at_begining_of_output = 0;
-            auto decoded = decoder.decode_bytes(out_it, decoded_data.end(), 
-                                                decoded_from_byte,
-                                                skip_bytes_at_begining_of_output);
-            
-            // D-4: Check if size matches
-            if (decoded.written == total_data_size) {
-                // [Core] Write file in 'binary' mode
-                std::ofstream out_file(output_filename, std::ios::binary);
-                out_file.write(reinterpret_cast<const char*>(decoded_data.data()), decoded_data.size());
-                out_file.close();
-
-                std::cout << "[SUCCESS] Decode complete! Restored image saved to " << output_filename << std::endl;
-            } else {
-                std::cerr << "[FAILURE] Decode failed. Wrote " << decoded.written << " bytes, expected " << total_data_size << std::endl;
-            }
-        }
-    } else {
+    if (fec.hashMismatches() > 0) std::cout << "  Content hash mismatches: " << fec.hashMismatches() << std::endl;
+    if (fec.decoded()) {
+        // D-1: 모든 블록 복원 완료 (hole만 파일에 기록됨), metadata가 있으면 hash도 일치
+        if (fec.hashStatus() == FecDecoder::HashStatus::MATCH) std::cout << "  Content hash verified (xxHash64)" << std::endl;
+        else std::cout << "  [Warning] No transfer metadata received, content hash not verified" << std::endl;
+        std::cout << "[SUCCESS] Decode complete! Restored image saved to " << output_filename << std::endl;
+    } else if (!decode_failed) {
         std::cerr << "[FAILURE] Decode failed. Not enough valid symbols received." << std::endl;
-        std::cerr << "  (Received " << received_count << " valid symbols, needed " << num_source_symbols << ")" << std::endl;
+        std::cerr << "  (" << fec.blocksReady() << "/" << fec.blocks().size() << " blocks ready, received " << fec.received()
+                  << " valid symbols, needed " << fec.sourceSymbols() << ")" << std::endl;
+    }
+    // D-3: 출력 파일에서 확정된 구간 (나머지는 0)
+    if (!fec.decoded()) {
+        std::cout << "  Partial output " << output_filename << ": " << fec.validBytes() << "/" << total_data_size
+                  << " bytes valid " << format_ranges(fec.validRanges()) << std::endl;
     }
+    out_file.close();
 
     return 0;
 }
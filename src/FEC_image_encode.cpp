@@ -6,20 +6,85 @@
 #include <RaptorQ/RaptorQ_v1_hdr.hpp>       // RaptorQ Library
 #include <cstdio>
 #include <cmath>
+#include <algorithm>
+#include <memory>
 
 #include "base64.h"
+#include "Base64Simd.hpp"
+#include "FecBlocks.hpp"
+#include "LossEstimator.hpp"
+#include "MatrixCache.hpp"
+#include "PacketContainer.hpp"
+#include "Packetizer.hpp"
+#include "TransferMeta.hpp"
+#include "XxHash64.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
     std::cout << "--- [TEST 1: CORRECT] Encoding(ID + Payload) to File  ---" << std::endl;
 
     // ==========================================================
     // A: File Setup & Read Original Data
     // ==========================================================
-    const std::string output_filename = "../data/encoded_correct_image.txt";
+    std::string output_filename = "../data/encoded_correct_image.txt";
     const std::string filename = "../data/sample_image.jpg";
     uint16_t symbol_size = 32;
-    const double overhead_ratio = 10.0;
+    double overhead_ratio = -1.0;   // --overhead P 로 고정, 없으면 손실률 추정치로 선택
+
+    // Options: --blocks N (multi-block mode, at least N source blocks)
+    //          --threads N (encoder worker threads, default: all cores)
+    //          --format txt|bin (bin: binary container ../data/encoded_correct_image.fecb)
+    //          --mtu N (max AT+SEND characters; picks T and symbols per frame for the least airtime)
+    //          --address N / --target P (repair count for success probability P from the link loss estimate)
+    //          --overhead P (fixed overhead %, ignores the estimate) / --estimator FILE
+    //          --id full|compact (compact: 1-3 byte varint Payload ID, plain text packets only)
+    //          --check none|crc32c (crc32c: 4-byte CRC32C per packet, not for --mtu frames)
+    //          --matrix-cache DIR|none (per-K repair coefficients, default ../data/matrix_cache)
+    uint32_t min_blocks = 1;
+    unsigned num_threads = 0;
+    bool binary_output = false;
+    size_t mtu = 0;
+    PacketFormat format;
+    int address = 0;
+    double target = DEFAULT_TARGET_SUCCESS;
+    std::string estimator_path = DEFAULT_LOSS_ESTIMATE_FILE;
+    std::string matrix_cache_dir = DEFAULT_MATRIX_CACHE_DIR;
+    for (int i = 1; i < argc; i += 2) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) opt.clear();
+        if (opt == "--blocks") min_blocks = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--threads") num_threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+        else if (opt == "--mtu") mtu = static_cast<size_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--address") address = std::stoi(argv[i + 1]);
+        else if (opt == "--target") target = std::stod(argv[i + 1]);
+        else if (opt == "--overhead") overhead_ratio = std::stod(argv[i + 1]);
+        else if (opt == "--estimator") estimator_path = argv[i + 1];
+        else if (opt == "--matrix-cache") matrix_cache_dir = argv[i + 1];
+        else if (opt == "--format" && (std::string(argv[i + 1]) == "txt" || std::string(argv[i + 1]) == "bin")) {
+            binary_output = (std::string(argv[i + 1]) == "bin");
+        }
+        else if (opt == "--id" && (std::string(argv[i + 1]) == "full" || std::string(argv[i + 1]) == "compact")) {
+            format.compact_id = (std::string(argv[i + 1]) == "compact");
+        }
+        else if (opt == "--check" && (std::string(argv[i + 1]) == "none" || std::string(argv[i + 1]) == "crc32c")) {
+            format.crc = (std::string(argv[i + 1]) == "crc32c");
+        }
+        else {
+            std::cerr << "[ERROR] Usage: ./FEC_image_encode [--blocks N] [--threads N] [--format txt|bin] [--mtu N] [--id full|compact]" << std::endl;
+            std::cerr << "                                    [--check none|crc32c] [--matrix-cache DIR|none]" << std::endl;
+            std::cerr << "                                    [--address N] [--target P] [--overhead P] [--estimator FILE]" << std::endl;
+            return 1;
+        }
+    }
+    // Frame headers and container records keep the fixed 4-byte ID, frames carry no CRC trailer
+    if (format.compact_id && (mtu > 0 || binary_output)) {
+        std::cerr << "[ERROR] --id compact cannot be combined with --mtu or --format bin" << std::endl;
+        return 1;
+    }
+    if (format.crc && mtu > 0) {
+        std::cerr << "[ERROR] --check crc32c cannot be combined with --mtu" << std::endl;
+        return 1;
+    }
 
     // A-1: Read file in 'binary' mode
     std::ifstream file(filename, std::ios::binary);
@@ -39,97 +104,160 @@ int main()
     std::cout << " Total size: " << source_data.size() << " bytes" << std::endl;
 
     // ==========================================================
-    // B: RaptorQ Encoder Setup
+    // B: Source Block Partition & Parallel Encoding
     // ==========================================================
-    namespace RaptorQ = RaptorQ__v1;
-    using namespace RaptorQ;
 
-    using InputIt = std::vector<uint8_t>::iterator;
-    using OutputIt = std::vector<uint8_t>::iterator;
-    using Encoder = RaptorQ::Encoder<InputIt, OutputIt>;
+    // B-0: Adaptive overhead (per-destination loss estimate -> repair count for the target success probability)
+    //      MTU packing changes T, so it is chosen again with the final T
+    const bool adaptive = overhead_ratio < 0;
+    if (adaptive) {
+        overhead_ratio = adaptive_overhead_ratio(estimator_path, address, source_data.size(), symbol_size, min_blocks, target, mtu == 0);
+    }
+
+    // B-0-1: MTU-aware packing (n is stored in the first byte of every frame)
+    uint8_t symbols_per_frame = 1;
+    if (mtu > 0) {
+        Packing packing = choose_packing(source_data.size(), overhead_ratio, mtu, LoRaParams(), min_blocks);
+        if (packing.symbols_per_frame == 0) {
+            std::cerr << "[ERROR] MTU " << mtu << " is too small for a frame" << std::endl;
+            return 1;
+        }
+        symbol_size = packing.symbol_size;
+        symbols_per_frame = packing.symbols_per_frame;
+        std::cout << " MTU " << mtu << ": symbol size " << symbol_size << ", " << static_cast<int>(symbols_per_frame)
+                  << " symbol(s)/frame, " << packing.frames << " frames, airtime " << packing.airtime_ms << " ms" << std::endl;
+        if (adaptive) {
+            overhead_ratio = adaptive_overhead_ratio(estimator_path, address, source_data.size(), symbol_size, min_blocks, target, true);
+        }
+    }
 
     // B-1: Calculate minimum symbols needed
     uint32_t min_symbol = (source_data.size() + symbol_size - 1) / symbol_size;
 
-    // B-2: Find valid Block_Size (most robust method)
-    Block_Size block = Block_Size::Block_10;
-    for(auto blk : *blocks) {
-        if (static_cast<uint16_t>(blk) >= min_symbol){
-            block = blk;
-            break;
-        }
+    // B-2: Split into source blocks (single block if the file fits in one Block_Size)
+    std::vector<SourceBlock> blocks = partition_source_blocks(source_data.size(), symbol_size, min_blocks);
+    if (blocks.empty()) {
+        std::cerr << "[ERROR] File too large: needs more than " << MAX_SOURCE_BLOCKS << " source blocks" << std::endl;
+        return 1;
     }
-    // B-3: Actual source symbols (K) is the selected block size
-    uint32_t num_source_symbols = static_cast<uint32_t>(block);
 
     std::cout << " Min symbols needed: " << min_symbol << std::endl;
-    std::cout << " Selected Block Size(K): " << num_source_symbols << std::endl;
-
-    Encoder encoder(block, symbol_size);
+    std::cout << " Source blocks (Z): " << blocks.size() << std::endl;
+    for (const auto& sb : blocks) {
+        std::cout << "  [SBN " << static_cast<int>(sb.sbn) << "] offset " << sb.offset
+                  << ", " << sb.length << " bytes, Block Size(K): " << static_cast<uint32_t>(sb.block) << std::endl;
+    }
 
-    // B-4: Set data to encoder and compute
-    encoder.set_data(source_data.begin(), source_data.end());
+    // B-3: compute_sync + symbol generation, one worker thread per block (cached K: no compute_sync)
     std::cout << "Computing symbols... " << std::endl;
-    if (!encoder.compute_sync()){
-        std::cerr << "Encoder pre-computation failed" << std::endl;
-        return 1;
-    }
+    std::unique_ptr<MatrixCache> matrix_cache;
+    if (matrix_cache_dir != "none") matrix_cache.reset(new MatrixCache(matrix_cache_dir));
+    std::vector<EncodedBlock> encoded = encode_blocks_parallel(source_data, blocks, symbol_size,
+                                                               overhead_ratio, num_threads, matrix_cache.get());
+    if (matrix_cache) std::cout << " Matrix cache (" << matrix_cache_dir << "): " << matrix_cache->summary() << std::endl;
 
     // ==========================================================
-    // C: Symbol Generation & File Save (ID + Payload)
+    // C: File Save ([SBN | ESI] + Payload)
     // ==========================================================
 
-    // C-1: Calculate repair symbols and total symbols
-    uint32_t num_repair_symbols = static_cast<uint32_t>(ceil(num_source_symbols * (overhead_ratio / 100.0)));
-    uint32_t total_symbols_to_send = num_source_symbols + num_repair_symbols;
+    // C-1: Check every block's encoder result
+    const size_t packet_size = PAYLOAD_ID_SIZE + symbol_size;
+    uint32_t total_symbols_to_send = 0;
 
-    std::cout << " Repair symbols: " << num_repair_symbols << std::endl;
-    std::cout << " Total symbols to send: " << total_symbols_to_send << std::endl;
+    for (const auto& eb : encoded) {
+        if (!eb.ok) {
+            std::cerr << "Encoder pre-computation failed (SBN " << static_cast<int>(eb.sbn) << ")" << std::endl;
+            return 1;
+        }
+        std::cout << " [SBN " << static_cast<int>(eb.sbn) << "] Repair symbols: "
+                  << (eb.num_packets - eb.num_source_symbols) << std::endl;
+        total_symbols_to_send += eb.num_packets;
+    }
+
+    // C-2: Binary container (records written as-is, no Base64)
+    if (binary_output) {
+        output_filename = "../data/encoded_correct_image.fecb";
+        ContainerHeader header;
+        header.symbol_size = symbol_size;
+        header.transfer_length = source_data.size();
+        header.has_hash = true;
+        header.content_hash = xxh64(source_data.data(), source_data.size());
+        header.num_source_symbols = static_cast<uint32_t>(blocks[0].block);
+        header.num_blocks = static_cast<uint16_t>(blocks.size());
+        header.record_size = static_cast<uint16_t>(packet_size + (format.crc ? PACKET_CRC_SIZE : 0));
+
+        ContainerWriter writer;
+        if (!writer.open(output_filename, header)) {
+            std::cerr << "Error: Cannot open file" << output_filename << std::endl;
+            return 1;
+        }
+        std::vector<uint8_t> record(packet_buffer_size(symbol_size));
+        for (const auto& eb : encoded) {
+            for (uint32_t i = 0; i < eb.num_packets; ++i) {
+                writer.append(record.data(), format_packet(eb.packets.data() + i * packet_size, symbol_size, format, record.data()));
+            }
+        }
+        if (!writer.close()) {
+            std::cerr << "Error: Cannot write file" << output_filename << std::endl;
+            return 1;
+        }
+        std::cout << "[SUCCESS] Container saved to " << output_filename << ". Total " << total_symbols_to_send << " symbols." << std::endl;
+        return 0;
+    }
 
-    // C-2: Open output file for symbols
+    // C-3: Text export (one Base64 line per packet, block order, source symbols first)
     std::ofstream output_file(output_filename);
     if (!output_file){
         std::cerr << "Error: Cannot open file" << output_filename << std::endl;
         return 1;
     }
 
-    // C-3: Save source/repair symbols in a single loop
-    std::cout << "Saving " << total_symbols_to_send << " (ID+Payload) packets to " << output_filename << "..." << std::endl;
-
-    auto src_it = encoder.begin_source();
-    auto repair_it = encoder.begin_repair();
-
-    std::vector<uint8_t> payload(symbol_size); // 32-byte payload buffer
-    std::vector<uint8_t> final_packet(4 + symbol_size); // 36-byte final packet buffer (pre-allocated)
-
-    for (uint32_t i=0; i < total_symbols_to_send; ++i){
+    std::vector<char> line_buf(base64_encoded_size(std::max<size_t>({ FRAME_HEADER_SIZE + symbols_per_frame * symbol_size,
+                                                                      packet_buffer_size(symbol_size), META_RECORD_SIZE })));  // Base64 line buffer (reused)
+    size_t line_len = 0;
+    auto write_line = [&](const uint8_t* data, size_t size) {
+        base64_encode_to(data, size, line_buf.data(), line_buf.size(), line_len);
+        output_file.write(line_buf.data(), line_len) << "\n";
+        return static_cast<bool>(output_file);
+    };
 
-        uint32_t current_id;
-        auto out_it = payload.begin();
+    // Metadata record first, after every META_REPEAT_INTERVAL data lines, and last
+    //  (OTI: F / T / Z / K / transfer ID + xxHash64 of the source -> the decoder sizes itself from it)
+    TransferMeta meta = make_transfer_meta(source_data.size(), symbol_size, static_cast<uint16_t>(blocks.size()),
+                                           static_cast<uint16_t>(blocks[0].block), true,
+                                           xxh64(source_data.data(), source_data.size()));
+    uint8_t meta_record[META_RECORD_SIZE];
+    encode_transfer_meta(meta, meta_record);
+    write_line(meta_record, META_RECORD_SIZE);
+    uint32_t data_lines = 0;
+    auto write_data_line = [&](const uint8_t* data, size_t size) {
+        if (!write_line(data, size)) return false;
+        return ++data_lines % META_REPEAT_INTERVAL != 0 || write_line(meta_record, META_RECORD_SIZE);
+    };
 
-        if(i < num_source_symbols){
-                current_id = (*src_it).id();
-                (*src_it)(out_it, payload.end());
-                ++src_it;
+    if (mtu > 0) {
+        // One line per frame ([n | SBN | ESI] + n symbols), frames never cross blocks
+        Packetizer packetizer(symbol_size, symbols_per_frame, write_data_line);
+        for (const auto& eb : encoded) {
+            for (uint32_t i = 0; i < eb.num_packets; ++i) packetizer.add(eb.packets.data() + i * packet_size);
+            packetizer.flush();
         }
-        else {
-                current_id = (*repair_it).id();
-                (*repair_it)(out_it, payload.end());
-                ++repair_it;
+    } else if (format.compact_id || format.crc) {
+        // [varint ID 1-3B or 4B ID | symbol | (CRC32C)], SBN width from the block count
+        format.sbn_bits = sbn_bits_for(blocks.size());
+        std::vector<uint8_t> formatted(packet_buffer_size(symbol_size));
+        for (const auto& eb : encoded) {
+            for (uint32_t i = 0; i < eb.num_packets; ++i) {
+                write_data_line(formatted.data(), format_packet(eb.packets.data() + i * packet_size, symbol_size, format, formatted.data()));
+            }
+        }
+    } else {
+        for (const auto& eb : encoded) {
+            for (uint32_t i = 0; i < eb.num_packets; ++i) write_data_line(eb.packets.data() + i * packet_size, packet_size);
         }
-
-        // C-4: Combine [ID 4 bytes] + [Payload 32 bytes]
-        final_packet[0] = (current_id >> 24) & 0xFF;
-        final_packet[1] = (current_id >> 16) & 0xFF;
-        final_packet[2] = (current_id >> 8) & 0xFF;
-        final_packet[3] = current_id & 0xFF;
-        std::copy(payload.begin(), payload.end(), final_packet.begin() + 4);
-
-        // C-5: Encode to Base64 and write to file
-        std::string base64_output = base64_encode(final_packet.data(), final_packet.size());
-        output_file << base64_output << "\n";
     }
 
+    if (data_lines % META_REPEAT_INTERVAL != 0) write_line(meta_record, META_RECORD_SIZE);
     output_file.close();
     std::cout << "[SUCCESS] File saved successfully. Total " << total_symbols_to_send << " symbols." << std::endl;
 
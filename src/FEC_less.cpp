@@ -8,6 +8,7 @@
 #include <cmath>
 
 #include "base64.h"
+#include "Base64Simd.hpp"
 
 int main()
 {
@@ -75,6 +76,9 @@ int main()
     auto src_it = encoder.begin_source();
     auto repair_it = encoder.begin_repair();
 
+    std::vector<char> line_buf(base64_encoded_size(symbol_size));  // Base64 한 줄 버퍼 (재사용)
+    size_t line_len = 0;
+
     for (uint32_t i = 0; i < total_symbols_to_send; ++i){
         uint32_t current_id;
 
@@ -92,9 +96,9 @@ int main()
             ++repair_it;
         }
 
-        std::string base64_output = base64_encode(payload.data(), payload.size());
+        base64_encode_to(payload.data(), payload.size(), line_buf.data(), line_buf.size(), line_len);
 
-        output_file << base64_output << "\n";
+        output_file.write(line_buf.data(), line_len) << "\n";
     }
 
     output_file.close();
@@ -0,0 +1,207 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <RaptorQ/RaptorQ_v1_hdr.hpp>       // RaptorQ Library
+#include <cstdio>
+#include <algorithm>
+
+#include "base64.h"
+#include "Base64Simd.hpp"
+#include "StreamEncoder.hpp"
+#include "MatrixCache.hpp"
+#include "LossEstimator.hpp"
+#include "PacketContainer.hpp"
+#include "TransferMeta.hpp"
+#include "LoRaModule.hpp"
+#include "LoRaTxQueue.hpp"
+#include <memory>
+
+// --- Streaming Encoder (대용량 파일: 펌웨어 이미지, 로그 번들 등) ---
+int main(int argc, char* argv[])
+{
+    // ==========================================================
+    // A: Options
+    // ==========================================================
+    if (argc < 3) {
+        std::cout << "[Error] Usage: ./FEC_stream_encode <input_file> <output_file> [--block-bytes N] [--symbol-size N] [--format txt|bin] [--send <serial_port>] [--address N]" << std::endl;
+        std::cout << "                                      [--target P] [--overhead P] [--estimator FILE] [--id full|compact] [--check none|crc32c]" << std::endl;
+        std::cout << "                                      [--matrix-cache DIR|none] [--threads N]" << std::endl;
+        std::cout << "  Example: ./FEC_stream_encode firmware.bin ../data/encoded_firmware.txt --block-bytes 1048576" << std::endl;
+        return 1;
+    }
+
+    const std::string input_filename = argv[1];
+    const std::string output_filename = argv[2];
+    uint16_t symbol_size = 32;
+    double overhead_ratio = -1.0;           // --overhead P 로 고정, 없으면 --address의 손실률 추정치로 선택
+    double target = DEFAULT_TARGET_SUCCESS;
+    std::string estimator_path = DEFAULT_LOSS_ESTIMATE_FILE;
+    size_t max_block_bytes = 1024 * 1024;   // 기본 1 MiB 블록 (메모리 상한 ≈ 2 블록)
+    bool binary_output = false;             // --format bin: .fecb 컨테이너
+    std::string send_port;                  // --send: 인코딩과 동시에 LoRa로 전송
+    int address = 0;
+    std::string matrix_cache_dir = DEFAULT_MATRIX_CACHE_DIR;   // K별 repair 계수 cache ("none": 끔)
+    unsigned num_threads = 0;               // --threads: repair 생성 thread 수 (기본값: 전체 코어)
+    PacketFormat format;                    // --id compact: 1~3 bytes varint Payload ID (txt / --send 전용)
+                                            // --check crc32c: 패킷마다 CRC32C 4 bytes
+
+    for (int i = 3; i < argc; i += 2) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) opt.clear();
+        if (opt == "--block-bytes") max_block_bytes = static_cast<size_t>(std::stoull(argv[i + 1]));
+        else if (opt == "--symbol-size") symbol_size = static_cast<uint16_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--send") send_port = argv[i + 1];
+        else if (opt == "--address") address = std::stoi(argv[i + 1]);
+        else if (opt == "--target") target = std::stod(argv[i + 1]);
+        else if (opt == "--overhead") overhead_ratio = std::stod(argv[i + 1]);
+        else if (opt == "--estimator") estimator_path = argv[i + 1];
+        else if (opt == "--matrix-cache") matrix_cache_dir = argv[i + 1];
+        else if (opt == "--threads") num_threads = static_cast<unsigned>(std::stoul(argv[i + 1]));
+        else if (opt == "--format" && (std::string(argv[i + 1]) == "txt" || std::string(argv[i + 1]) == "bin")) binary_output = std::string(argv[i + 1]) == "bin";
+        else if (opt == "--id" && (std::string(argv[i + 1]) == "full" || std::string(argv[i + 1]) == "compact")) format.compact_id = std::string(argv[i + 1]) == "compact";
+        else if (opt == "--check" && (std::string(argv[i + 1]) == "none" || std::string(argv[i + 1]) == "crc32c")) format.crc = std::string(argv[i + 1]) == "crc32c";
+        else {
+            std::cerr << "[ERROR] Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (format.compact_id && binary_output) {
+        std::cerr << "[ERROR] --id compact cannot be combined with --format bin (fixed-size records)" << std::endl;
+        return 1;
+    }
+
+    std::cout << "--- Streaming encode: " << input_filename << " ---" << std::endl;
+    std::cout << " Symbol size: " << symbol_size << " bytes, max block: " << max_block_bytes << " bytes" << std::endl;
+
+    // 모든 스트림 블록에 같은 overhead (스트림 블록 분할 전체가 target을 만족하도록)
+    if (overhead_ratio < 0) {
+        std::ifstream size_probe(input_filename, std::ios::binary | std::ios::ate);
+        uint64_t file_size = size_probe ? static_cast<uint64_t>(size_probe.tellg()) : 0;
+        overhead_ratio = adaptive_overhead_ratio(estimator_path, address, StreamEncoder::partition(file_size, symbol_size, max_block_bytes),
+                                                 target, true);
+    }
+
+    // 원본 xxHash64 + 블록 분할 (metadata record의 OTI / 컨테이너 헤더, 디코더가 첫 record로 Decoder 생성)
+    uint64_t content_hash = 0, transfer_length = 0;
+    if (!StreamEncoder::hashFile(input_filename, content_hash, transfer_length)) {
+        std::cerr << "[ERROR] Cannot read input file: " << input_filename << std::endl;
+        return 1;
+    }
+    std::vector<SourceBlock> plan = StreamEncoder::partition(transfer_length, symbol_size, max_block_bytes);
+    if (plan.empty()) {
+        std::cerr << "[ERROR] File too large: " << transfer_length << " bytes, limit " << StreamEncoder::maxTransferLength(symbol_size)
+                  << " bytes (" << MAX_SOURCE_BLOCKS << " source blocks of " << max_block_symbols() << " symbols x " << symbol_size << " bytes)" << std::endl;
+        return 1;
+    }
+    TransferMeta meta = make_transfer_meta(transfer_length, symbol_size, static_cast<uint16_t>(plan.size()),
+                                           static_cast<uint16_t>(plan[0].block), true, content_hash);
+
+    // ==========================================================
+    // B: Output File
+    // ==========================================================
+    std::ofstream output_file;
+    ContainerWriter container;
+    if (binary_output) {
+        ContainerHeader header;
+        header.symbol_size = symbol_size;
+        header.has_hash = true;
+        header.content_hash = content_hash;
+        header.record_size = static_cast<uint16_t>(PAYLOAD_ID_SIZE + symbol_size + (format.crc ? PACKET_CRC_SIZE : 0));
+        if (!container.open(output_filename, header)) {
+            std::cerr << "[ERROR] Cannot open output file: " << output_filename << std::endl;
+            return 1;
+        }
+    } else {
+        output_file.open(output_filename);
+        if (!output_file) {
+            std::cerr << "[ERROR] Cannot open output file: " << output_filename << std::endl;
+            return 1;
+        }
+    }
+
+    // B-1: (선택) LoRa 전송 queue -> 다음 블록을 인코딩하는 동안 이전 패킷을 전송
+    std::unique_ptr<LoRaModule> module;
+    std::unique_ptr<LoRaTxQueue> tx_queue;
+    if (!send_port.empty()) {
+        try {
+            module.reset(new LoRaModule(send_port, B115200));
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] " << e.what() << std::endl;
+            return 1;
+        }
+        tx_queue.reset(new LoRaTxQueue(*module, address));
+    }
+
+    // ==========================================================
+    // C: Encode block by block ([SBN | ESI] + Payload -> Base64 line / record)
+    // ==========================================================
+    StreamEncoder encoder(symbol_size, overhead_ratio);
+    std::unique_ptr<MatrixCache> matrix_cache;
+    if (matrix_cache_dir != "none") matrix_cache.reset(new MatrixCache(matrix_cache_dir));
+    encoder.setMatrixCache(matrix_cache.get());
+    encoder.setThreads(num_threads);
+    std::vector<char> line_buf(base64_encoded_size(std::max(packet_buffer_size(symbol_size), META_RECORD_SIZE)));
+    std::vector<uint8_t> formatted(packet_buffer_size(symbol_size));
+    // Base64 한 줄을 LoRa queue / 텍스트 파일로 (컨테이너 레코드는 따로)
+    auto emit_line = [&](const uint8_t* data, size_t size) {
+        size_t line_len = 0;
+        base64_encode_to(data, size, line_buf.data(), line_buf.size(), line_len);
+        if (tx_queue && !tx_queue->push(std::string(line_buf.data(), line_len))) return false;
+        if (binary_output) return true;
+        output_file.write(line_buf.data(), line_len) << "\n";
+        return static_cast<bool>(output_file);
+    };
+
+    // 처음, META_REPEAT_INTERVAL개의 패킷마다, 끝에 metadata record (컨테이너는 헤더에 OTI / hash)
+    uint8_t meta_record[META_RECORD_SIZE];
+    encode_transfer_meta(meta, meta_record);
+    const bool text_stream = tx_queue || !binary_output;
+    uint64_t data_lines = 0;
+    bool ok = !text_stream || emit_line(meta_record, META_RECORD_SIZE);
+    ok = ok && encoder.encodeFile(input_filename, max_block_bytes,
+        [&](const uint8_t* packet, size_t size) {
+            // Z는 첫 패킷 전에 이미 결정됨 (encodeFile이 파일 크기로 블록 분할)
+            if (format.compact_id || format.crc) {
+                format.sbn_bits = sbn_bits_for(encoder.blocks().size());
+                size = format_packet(packet, symbol_size, format, formatted.data());
+                packet = formatted.data();
+            }
+            if (text_stream) {
+                if (!emit_line(packet, size)) return false;
+                if (++data_lines % META_REPEAT_INTERVAL == 0 && !emit_line(meta_record, META_RECORD_SIZE)) return false;
+            }
+            return !binary_output || container.append(packet, size);
+        });
+    if (ok && text_stream && data_lines % META_REPEAT_INTERVAL != 0) ok = emit_line(meta_record, META_RECORD_SIZE);
+
+    if (binary_output) {
+        // F/K/Z는 파일을 다 읽은 뒤에 확정됨
+        ContainerHeader& header = container.header();
+        header.transfer_length = encoder.transferLength();
+        if (!encoder.blocks().empty()) header.num_source_symbols = static_cast<uint32_t>(encoder.blocks()[0].block);
+        header.num_blocks = static_cast<uint16_t>(encoder.blocks().size());
+        ok = container.close() && ok;
+    } else {
+        output_file.close();
+    }
+
+    if (tx_queue) {
+        tx_queue->close();
+        LoRaTxQueue::Stats stats = tx_queue->stats();
+        std::cout << " LoRa: sent " << stats.sent << ", failed " << stats.failed
+                  << ", max queue " << stats.max_depth << ", " << stats.packets_per_sec << " packets/s" << std::endl;
+    }
+
+    if (!ok) {
+        std::cerr << "[FAILURE] Streaming encode failed." << std::endl;
+        return 1;
+    }
+
+    std::cout << " Total size: " << encoder.transferLength() << " bytes" << std::endl;
+    std::cout << " Source blocks (Z): " << encoder.blocks().size() << std::endl;
+    if (matrix_cache) std::cout << " Matrix cache (" << matrix_cache_dir << "): " << matrix_cache->summary() << std::endl;
+    std::cout << "[SUCCESS] " << encoder.packetsEmitted() << " packets saved to " << output_filename << std::endl;
+
+    return 0;
+}
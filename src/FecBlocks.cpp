@@ -0,0 +1,292 @@
+#include "FecBlocks.hpp"
+#include "Crc32c.hpp"
+#include "MatrixCache.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+namespace RaptorQ = RaptorQ__v1;
+
+RaptorQ::Block_Size select_block_size(uint32_t min_symbols)
+{
+    RaptorQ::Block_Size block = RaptorQ::Block_Size::Block_10;
+    for (auto blk : *RaptorQ::blocks) {
+        block = blk;
+        if (static_cast<uint32_t>(blk) >= min_symbols) break;
+    }
+    return block;
+}
+
+uint32_t max_block_symbols()
+{
+    return static_cast<uint32_t>(RaptorQ::blocks->back());
+}
+
+uint8_t sbn_bits_for(size_t num_blocks)
+{
+    uint8_t bits = 0;
+    while ((static_cast<size_t>(1) << bits) < num_blocks) ++bits;
+    return bits;
+}
+
+size_t write_compact_id(uint8_t* out, uint8_t sbn, uint32_t esi, uint8_t sbn_bits)
+{
+    uint64_t value = (static_cast<uint64_t>(esi) << sbn_bits) | sbn;
+    if (value >= (static_cast<uint64_t>(1) << (7 * COMPACT_ID_MAX_SIZE))) return 0;
+    size_t n = 0;
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[n++] = value ? (byte | 0x80) : byte;
+    } while (value);
+    return n;
+}
+
+size_t read_any_payload_id(const uint8_t* packet, size_t len, uint16_t symbol_size, uint8_t sbn_bits,
+                           uint8_t& sbn, uint32_t& esi)
+{
+    if (len <= symbol_size) return 0;
+    size_t id_len = len - symbol_size;
+    if (id_len == PAYLOAD_ID_SIZE) {
+        read_payload_id(packet, sbn, esi);
+        return id_len;
+    }
+    if (id_len > COMPACT_ID_MAX_SIZE) return 0;
+
+    uint32_t value = 0;
+    for (size_t i = 0; i < id_len; ++i) {
+        value |= static_cast<uint32_t>(packet[i] & 0x7F) << (7 * i);
+        // 마지막 byte만 continuation bit가 0
+        bool last = (packet[i] & 0x80) == 0;
+        if (last != (i + 1 == id_len)) return 0;
+    }
+    sbn = static_cast<uint8_t>(value & ((1u << sbn_bits) - 1));
+    esi = value >> sbn_bits;
+    return id_len;
+}
+
+size_t compact_packet(const uint8_t* packet, uint16_t symbol_size, uint8_t sbn_bits, uint8_t* out)
+{
+    uint8_t sbn;
+    uint32_t esi;
+    read_payload_id(packet, sbn, esi);
+    size_t id_len = write_compact_id(out, sbn, esi, sbn_bits);
+    if (id_len == 0) {
+        std::memcpy(out, packet, PAYLOAD_ID_SIZE + symbol_size);
+        return PAYLOAD_ID_SIZE + symbol_size;
+    }
+    std::memcpy(out + id_len, packet + PAYLOAD_ID_SIZE, symbol_size);
+    return id_len + symbol_size;
+}
+
+size_t append_packet_crc(uint8_t* packet, size_t len)
+{
+    uint32_t crc = crc32c(packet, len);
+    for (size_t i = 0; i < PACKET_CRC_SIZE; ++i) packet[len + i] = static_cast<uint8_t>(crc >> (8 * i));
+    return len + PACKET_CRC_SIZE;
+}
+
+PacketCheck check_packet_crc(const uint8_t* packet, size_t& len, uint16_t symbol_size)
+{
+    // ID 1~4 bytes + CRC 4 bytes 일 때만 trailer가 있음
+    if (len <= symbol_size + PAYLOAD_ID_SIZE || len > symbol_size + PAYLOAD_ID_SIZE + PACKET_CRC_SIZE) return PacketCheck::NONE;
+    size_t body = len - PACKET_CRC_SIZE;
+    uint32_t stored = 0;
+    for (size_t i = 0; i < PACKET_CRC_SIZE; ++i) stored |= static_cast<uint32_t>(packet[body + i]) << (8 * i);
+    if (crc32c(packet, body) != stored) return PacketCheck::BAD;
+    len = body;
+    return PacketCheck::OK;
+}
+
+size_t format_packet(const uint8_t* packet, uint16_t symbol_size, const PacketFormat& format, uint8_t* out)
+{
+    size_t len = PAYLOAD_ID_SIZE + symbol_size;
+    if (format.compact_id) len = compact_packet(packet, symbol_size, format.sbn_bits, out);
+    else std::memcpy(out, packet, len);
+    if (format.crc) len = append_packet_crc(out, len);
+    return len;
+}
+
+std::vector<SourceBlock> partition_source_blocks(size_t transfer_length, uint16_t symbol_size,
+                                                 uint32_t min_blocks)
+{
+    std::vector<SourceBlock> result;
+    if (symbol_size == 0) return result;
+
+    // Kt: 전체 source symbol 수, Z: 블록 수
+    uint32_t kt = static_cast<uint32_t>((transfer_length + symbol_size - 1) / symbol_size);
+    uint32_t k_max = max_block_symbols();
+    uint32_t z = std::max<uint32_t>(std::max<uint32_t>(min_blocks, 1), (kt + k_max - 1) / k_max);
+    z = std::min<uint32_t>(z, std::max<uint32_t>(kt, 1));
+    if (z > MAX_SOURCE_BLOCKS) return result;
+
+    // KL = ceil(Kt/Z), KS = floor(Kt/Z), 앞의 ZL개 블록이 KL개씩
+    uint32_t kl = (kt + z - 1) / z;
+    uint32_t ks = kt / z;
+    uint32_t zl = kt - ks * z;
+
+    size_t offset = 0;
+    for (uint32_t i = 0; i < z; ++i) {
+        uint32_t k = (i < zl) ? kl : ks;
+        size_t bytes = static_cast<size_t>(k) * symbol_size;
+
+        SourceBlock sb;
+        sb.sbn = static_cast<uint8_t>(i);
+        sb.offset = offset;
+        sb.length = std::min(bytes, transfer_length - offset);
+        sb.min_symbols = k;
+        sb.block = select_block_size(k);
+        result.push_back(sb);
+
+        offset += sb.length;
+    }
+    return result;
+}
+
+void parallel_for_ranges(size_t count, size_t min_chunk, unsigned num_threads,
+                         const std::function<void(size_t, size_t)>& fn)
+{
+    if (count == 0) return;
+    if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 1;
+
+    // thread마다 chunk 몇 개씩 -> 끝에서 한 thread만 남아 도는 시간이 짧음
+    size_t chunk = std::max<size_t>(std::max<size_t>(min_chunk, 1), (count + num_threads * 4 - 1) / (num_threads * 4));
+    size_t num_chunks = (count + chunk - 1) / chunk;
+    num_threads = static_cast<unsigned>(std::min<size_t>(num_threads, num_chunks));
+
+    std::atomic<size_t> next_chunk(0);
+    auto worker = [&]() {
+        for (size_t c = next_chunk++; c < num_chunks; c = next_chunk++) {
+            fn(c * chunk, std::min(count, (c + 1) * chunk));
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < num_threads; ++t) workers.emplace_back(worker);
+    worker();
+    for (auto& th : workers) th.join();
+}
+
+namespace {
+
+using BlockEncoder = RaptorQ::Encoder<std::vector<uint8_t>::iterator, std::vector<uint8_t>::iterator>;
+
+// 한 블록의 repair 생성에 필요한 상태 (prepare_block에서 만들고, repair 단계에서는 읽기만)
+struct BlockWork {
+    uint32_t num_repair_symbols = 0;
+    std::unique_ptr<BlockEncoder> encoder;          // cache 없음: compute_sync 끝난 encoder
+    std::shared_ptr<const RepairMatrix> matrix;     // cache 있음: G
+    std::vector<uint8_t> padded;                    // 마지막 블록처럼 K * T보다 짧으면 0-padding 복사본
+    const uint8_t* source = nullptr;                // K * T bytes (원본 또는 padded)
+};
+
+}   // namespace
+
+// A: 결과 버퍼 할당, compute_sync (또는 G 조회), source packet 기록
+static bool prepare_block(std::vector<uint8_t>& source_data, const SourceBlock& sb, uint16_t symbol_size,
+                          double overhead_ratio, MatrixCache* cache, EncodedBlock& out, BlockWork& work)
+{
+    uint32_t num_source_symbols = static_cast<uint32_t>(sb.block);
+    work.num_repair_symbols = repair_symbol_count(num_source_symbols, overhead_ratio);
+    const size_t packet_size = PAYLOAD_ID_SIZE + symbol_size;
+
+    out.sbn = sb.sbn;
+    out.num_source_symbols = num_source_symbols;
+    out.num_packets = num_source_symbols + work.num_repair_symbols;
+    out.packets.assign(out.num_packets * packet_size, 0);
+
+    // cache된 G가 있으면 compute_sync 없이: source = 원본 그대로, repair = G * source
+    work.matrix = cache ? cache->get(sb.block, work.num_repair_symbols) : nullptr;
+    if (work.matrix) {
+        const size_t block_bytes = static_cast<size_t>(num_source_symbols) * symbol_size;
+        if (sb.length == block_bytes) {
+            work.source = source_data.data() + sb.offset;
+        } else {
+            work.padded.assign(block_bytes, 0);
+            std::copy(source_data.begin() + sb.offset, source_data.begin() + sb.offset + sb.length, work.padded.begin());
+            work.source = work.padded.data();
+        }
+        for (uint32_t i = 0; i < num_source_symbols; ++i) {
+            uint8_t* packet = out.packets.data() + i * packet_size;
+            std::memcpy(packet + PAYLOAD_ID_SIZE, work.source + static_cast<size_t>(i) * symbol_size, symbol_size);
+            write_payload_id(packet, sb.sbn, i);
+        }
+        return true;
+    }
+
+    work.encoder.reset(new BlockEncoder(sb.block, symbol_size));
+    work.encoder->set_data(source_data.begin() + sb.offset, source_data.begin() + sb.offset + sb.length);
+    if (!work.encoder->compute_sync()) return false;
+
+    // [Payload ID | symbol]을 결과 버퍼에 바로 기록 (임시 payload 복사 없음)
+    for (uint32_t esi = 0; esi < num_source_symbols; ++esi) {
+        auto packet = out.packets.begin() + esi * packet_size;
+        auto out_it = packet + PAYLOAD_ID_SIZE;
+        work.encoder->encode(out_it, packet + packet_size, esi);
+        write_payload_id(&*packet, sb.sbn, esi);
+    }
+    return true;
+}
+
+// B: repair packet [first, last) (ESI = K + r) -> 결과 버퍼의 자기 자리에만 씀
+//  - repair symbol은 intermediate symbol(또는 G)과 ESI만의 함수 -> 구간끼리 독립, 여러 thread에서 호출
+static void encode_repair_range(const SourceBlock& sb, uint16_t symbol_size, const BlockWork& work,
+                                EncodedBlock& out, uint32_t first, uint32_t last)
+{
+    const size_t packet_size = PAYLOAD_ID_SIZE + symbol_size;
+    for (uint32_t r = first; r < last; ++r) {
+        uint32_t esi = out.num_source_symbols + r;
+        auto packet = out.packets.begin() + static_cast<size_t>(esi) * packet_size;
+        if (work.matrix) {
+            work.matrix->encodeRepair(r, work.source, symbol_size, &*packet + PAYLOAD_ID_SIZE);
+        } else {
+            auto out_it = packet + PAYLOAD_ID_SIZE;
+            work.encoder->encode(out_it, packet + packet_size, esi);
+        }
+        write_payload_id(&*packet, sb.sbn, esi);
+    }
+}
+
+std::vector<EncodedBlock> encode_blocks_parallel(std::vector<uint8_t>& source_data,
+                                                 const std::vector<SourceBlock>& blocks,
+                                                 uint16_t symbol_size, double overhead_ratio,
+                                                 unsigned num_threads, MatrixCache* cache)
+{
+    std::vector<EncodedBlock> result(blocks.size());
+    std::vector<BlockWork> work(blocks.size());
+
+    // A: 블록마다 compute_sync (블록 단위로 나눔)
+    parallel_for_ranges(blocks.size(), 1, num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i].ok = prepare_block(source_data, blocks[i], symbol_size, overhead_ratio, cache, result[i], work[i]);
+        }
+    });
+
+    // B: 모든 블록의 repair symbol을 한 줄로 이어 ESI 구간 단위로 나눔
+    //  - 블록이 1개뿐이어도 (높은 overhead의 단일 블록) 모든 코어가 repair를 나눠 생성
+    //  - 각 packet의 위치는 (블록, ESI)로 정해져 있으므로 결과는 thread 수와 무관하게 같음
+    std::vector<size_t> repair_end(blocks.size());
+    size_t total_repair = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (result[i].ok) total_repair += work[i].num_repair_symbols;
+        repair_end[i] = total_repair;
+    }
+    parallel_for_ranges(total_repair, REPAIR_CHUNK_MIN_SYMBOLS, num_threads, [&](size_t begin, size_t end) {
+        size_t i = std::upper_bound(repair_end.begin(), repair_end.end(), begin) - repair_end.begin();
+        for (; begin < end; ++i) {
+            size_t block_begin = repair_end[i] - (result[i].ok ? work[i].num_repair_symbols : 0);
+            size_t block_end = std::min(end, repair_end[i]);
+            if (block_end > begin) {
+                encode_repair_range(blocks[i], symbol_size, work[i], result[i],
+                                    static_cast<uint32_t>(begin - block_begin), static_cast<uint32_t>(block_end - block_begin));
+                begin = block_end;
+            }
+        }
+    });
+
+    return result;
+}
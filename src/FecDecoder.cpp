@@ -0,0 +1,388 @@
+#include "FecDecoder.hpp"
+#include "Packetizer.hpp"
+#include "TransferMeta.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace RaptorQ = RaptorQ__v1;
+
+std::string format_ranges(const std::vector<ByteRange>& ranges, size_t max_ranges)
+{
+    std::ostringstream os;
+    for (size_t i = 0; i < ranges.size() && i < max_ranges; ++i) {
+        if (i) os << " ";
+        os << "[" << ranges[i].offset << ", " << ranges[i].offset + ranges[i].length << ")";
+    }
+    if (ranges.size() > max_ranges) os << " ... (" << ranges.size() - max_ranges << " more)";
+    if (ranges.empty()) os << "(none)";
+    return os.str();
+}
+
+FecDecoder::FecDecoder(uint64_t transfer_length, uint16_t symbol_size, uint32_t min_blocks)
+    : _transfer_length(transfer_length), _symbol_size(symbol_size)
+{
+    _blocks = partition_source_blocks(transfer_length, symbol_size, min_blocks);
+    if (_blocks.empty()) return;
+    _state.resize(_blocks.size());
+    size_t bits = 0;
+    for (size_t b = 0; b < _blocks.size(); ++b) {
+        const SourceBlock& sb = _blocks[b];
+        _decoders.emplace_back(new Decoder(sb.block, symbol_size, Decoder::Report::COMPLETE));
+        _source_symbols += static_cast<uint32_t>(sb.block);
+        _state[b].bitmap_base = bits;
+        bits += sb.min_symbols;
+    }
+    _bitmap.assign((bits + 63) / 64, 0);
+    _sbn_bits = sbn_bits_for(_blocks.size());
+    _data.assign(transfer_length, 0);
+    _hash_marks.assign(_blocks.size(), _hasher);
+}
+
+FecDecoder::FecDecoder(const TransferMeta& meta)
+    : FecDecoder(meta.transfer_length, meta.symbol_size, meta.has_oti ? meta.num_blocks : 1)
+{
+    // Z는 min_blocks로 넘기므로 F / T가 같으면 인코더와 같은 분할 -> 다르면 다른 설정의 record
+    if (!meta.has_oti || !matchesTransfer(meta)) {
+        _blocks.clear();
+        return;
+    }
+    _has_transfer_id = true;
+    _transfer_id = meta.transfer_id;
+    if (meta.has_hash) setExpectedHash(meta.content_hash);
+}
+
+bool FecDecoder::matchesTransfer(const TransferMeta& meta) const
+{
+    if (meta.transfer_length != _transfer_length) return false;
+    if (!meta.has_oti) return true;     // version 1: F만 확인
+    return meta.symbol_size == _symbol_size && meta.num_blocks == _blocks.size() &&
+           !_blocks.empty() && meta.num_source_symbols == static_cast<uint32_t>(_blocks[0].block) &&
+           (!_has_transfer_id || meta.transfer_id == _transfer_id);
+}
+
+bool FecDecoder::testAndSet(size_t bit)
+{
+    uint64_t mask = uint64_t(1) << (bit & 63);
+    uint64_t& word = _bitmap[bit >> 6];
+    if (word & mask) return true;
+    word |= mask;
+    return false;
+}
+
+template <typename Fn>
+void FecDecoder::forEachRun(size_t b, bool present, Fn fn) const
+{
+    const SourceBlock& sb = _blocks[b];
+    const BlockState& st = _state[b];
+    uint32_t esi = 0;
+    while (esi < sb.min_symbols) {
+        if (testBit(st.bitmap_base + esi) != present) {
+            ++esi;
+            continue;
+        }
+        uint32_t first = esi;
+        while (esi < sb.min_symbols && testBit(st.bitmap_base + esi) == present) ++esi;
+        uint64_t begin = static_cast<uint64_t>(first) * _symbol_size;
+        uint64_t end = std::min<uint64_t>(static_cast<uint64_t>(esi) * _symbol_size, sb.length);
+        fn(sb.offset + begin, static_cast<size_t>(end - begin));
+    }
+}
+
+FecDecoder::AddResult FecDecoder::addSymbol(uint8_t sbn, uint32_t esi, const uint8_t* payload)
+{
+    if (sbn >= _decoders.size()) return AddResult::UNKNOWN_BLOCK;
+    const SourceBlock& sb = _blocks[sbn];
+    BlockState& st = _state[sbn];
+    _arrived++;
+    st.esi_end = std::max(st.esi_end, esi + 1);
+    if (st.decoded) return AddResult::NOT_NEEDED;
+
+    // Fast path: 데이터가 들어 있는 source symbol은 제자리에 복사 (padding symbol은 항상 0)
+    bool new_source = false;
+    if (esi < sb.min_symbols) {
+        if (!testAndSet(st.bitmap_base + esi)) {
+            size_t offset = static_cast<size_t>(esi) * _symbol_size;
+            size_t len = std::min<size_t>(_symbol_size, sb.length - offset);
+            std::memcpy(_data.data() + sb.offset + offset, payload, len);
+            _valid_bytes += len;
+            if (_sink) _sink(sb.offset + offset, _data.data() + sb.offset + offset, len);
+            new_source = true;
+            if (++st.present == sb.min_symbols) {
+                // source symbol 완비 -> 행렬 디코딩 없이 완료
+                if (!st.ready) _blocks_ready++;
+                st.ready = true;
+                st.decoded = true;
+                st.fast_path = true;
+                _blocks_decoded++;
+                _fast_path_blocks++;
+                _received++;
+                st.received++;
+                advanceHash();
+                return AddResult::ADDED;
+            }
+            advanceHash();
+        }
+    }
+
+    // rank 부족으로 다시 연 블록은 decoder.ready()여도 심볼을 더 받음
+    Decoder& decoder = *_decoders[sbn];
+    if (st.ready) return new_source ? AddResult::ADDED : AddResult::NOT_NEEDED;
+
+    const uint8_t* from = payload;
+    auto err = decoder.add_symbol(from, payload + _symbol_size, esi);
+    if (err == RaptorQ::Error::NOT_NEEDED) return AddResult::NOT_NEEDED;
+    if (err != RaptorQ::Error::NONE) return AddResult::ERROR;
+    if (esi >= sb.min_symbols) {
+        st.extra_esi.push_back(esi);
+        st.extra_symbols.insert(st.extra_symbols.end(), payload, payload + _symbol_size);
+    }
+
+    _received++;
+    st.received++;
+    if (decoder.ready() && !st.ready && st.received >= st.retry_at) {
+        st.ready = true;
+        _blocks_ready++;
+    }
+    return AddResult::ADDED;
+}
+
+uint32_t FecDecoder::symbolsNeeded(uint8_t sbn) const
+{
+    if (sbn >= _blocks.size() || _state[sbn].ready) return 0;
+    uint32_t k = std::max(static_cast<uint32_t>(_blocks[sbn].block), _state[sbn].retry_at);
+    return std::max<uint32_t>(1, k - std::min(k, _state[sbn].received));
+}
+
+uint32_t FecDecoder::symbolsExpected() const
+{
+    uint32_t expected = 0;
+    for (const auto& st : _state) expected += st.esi_end;
+    return expected;
+}
+
+FecDecoder::AddResult FecDecoder::addPacket(const uint8_t* packet, size_t len)
+{
+    TransferMeta meta;
+    if (parse_transfer_meta(packet, len, meta)) {
+        if (!matchesTransfer(meta)) {
+            std::cerr << "[Warning] Metadata for another transfer (" << meta.transfer_length << " bytes, T=" << meta.symbol_size
+                      << ", Z=" << meta.num_blocks << ", expected " << _transfer_length << " bytes, T=" << _symbol_size
+                      << ", Z=" << _blocks.size() << "). Ignoring." << std::endl;
+            return AddResult::METADATA;
+        }
+        if (meta.has_oti && !_has_transfer_id) {
+            _has_transfer_id = true;
+            _transfer_id = meta.transfer_id;
+        }
+        if (meta.has_hash) setExpectedHash(meta.content_hash);
+        return AddResult::METADATA;
+    }
+    // CRC trailer가 있으면 먼저 검사 (실패한 패킷은 손실로 처리, add_symbol에 넣지 않음)
+    if (check_packet_crc(packet, len, _symbol_size) == PacketCheck::BAD) {
+        _checksum_failures++;
+        return AddResult::BAD_CHECKSUM;
+    }
+    // 4-byte ID / compact ID 모두 (길이 - T 로 구분)
+    uint8_t sbn;
+    uint32_t esi;
+    size_t id_len = read_any_payload_id(packet, len, _symbol_size, _sbn_bits, sbn, esi);
+    if (id_len == 0) return AddResult::BAD_SIZE;
+    return addSymbol(sbn, esi, packet + id_len);
+}
+
+FecDecoder::AddResult FecDecoder::addFrame(const uint8_t* frame, size_t len)
+{
+    if ((len == META_RECORD_SIZE || len == META_V1_RECORD_SIZE) && frame[0] == META_MAGIC) {
+        AddResult r = addPacket(frame, len);
+        if (r == AddResult::METADATA) return r;
+    }
+    FrameView fv;
+    if (!parse_frame(frame, len, fv) || fv.symbol_size != _symbol_size) return AddResult::BAD_SIZE;
+
+    AddResult result = AddResult::NOT_NEEDED;
+    for (uint8_t i = 0; i < fv.count; ++i) {
+        AddResult r = addSymbol(fv.sbn, fv.first_esi + i, fv.symbols + i * _symbol_size);
+        if (result != AddResult::ADDED) result = r;
+    }
+    return result;
+}
+
+bool FecDecoder::decode()
+{
+    if (!ready()) return false;
+    return decodeReadyBlocks() && decoded();
+}
+
+bool FecDecoder::decodeReadyBlocks()
+{
+    for (size_t b = 0; b < _decoders.size(); ++b) {
+        Decoder& decoder = *_decoders[b];
+        const SourceBlock& sb = _blocks[b];
+        BlockState& st = _state[b];
+        if (st.decoded || !st.ready) continue;
+
+        // repair symbol이 필요한 블록만 행렬 디코딩
+        decoder.end_of_input(RaptorQ::Fill_With_Zeros::NO);
+        auto res = decoder.wait_sync();
+        if (res.error == RaptorQ::Error::NEED_DATA) {
+            // 받은 심볼의 rank가 K보다 작음 (K + 몇 개로도 드물게 발생) -> 포기하지 않고 더 받음
+            std::cerr << "[Warning] Block " << b << " is rank deficient after " << st.received
+                      << " symbols. Waiting for more symbols." << std::endl;
+            rearmBlock(b);
+            continue;
+        }
+        if (res.error != RaptorQ::Error::NONE) {
+            std::cerr << "[FAILURE] Decode failed during wait_sync() (SBN " << b << "). Error code: " << static_cast<int>(res.error) << std::endl;
+            return false;
+        }
+
+        auto out_it = _data.begin() + sb.offset;
+        size_t decoded_from_byte = 0;
+        size_t skip_bytes_at_begining_of_output = 0;
+        auto decoded = decoder.decode_bytes(out_it, _data.begin() + sb.offset + sb.length,
+                                            decoded_from_byte, skip_bytes_at_begining_of_output);
+        if (decoded.written != sb.length) {
+            std::cerr << "[FAILURE] Decode failed (SBN " << b << "). Wrote " << decoded.written << " bytes, expected " << sb.length << std::endl;
+            return false;
+        }
+        st.decoded = true;
+        _blocks_decoded++;
+
+        // 이미 내보낸 source symbol은 그대로 두고 빠진 구간만 채움
+        forEachRun(b, false, [&](uint64_t offset, size_t len) {
+            _valid_bytes += len;
+            if (_sink) _sink(offset, _data.data() + offset, len);
+        });
+        advanceHash();
+    }
+    return true;
+}
+
+void FecDecoder::rearmBlock(size_t b)
+{
+    const SourceBlock& sb = _blocks[b];
+    BlockState& st = _state[b];
+    // end_of_input() 이후의 Decoder에는 심볼을 더 넣을 수 없음 -> 받은 심볼로 새로 만듦
+    _decoders[b].reset(new Decoder(sb.block, _symbol_size, Decoder::Report::COMPLETE));
+    Decoder& decoder = *_decoders[b];
+    std::vector<uint8_t> symbol(_symbol_size);
+    for (uint32_t esi = 0; esi < sb.min_symbols; ++esi) {
+        if (!testBit(st.bitmap_base + esi)) continue;
+        // 마지막 source symbol은 인코더처럼 0으로 padding
+        size_t offset = static_cast<size_t>(esi) * _symbol_size;
+        size_t len = std::min<size_t>(_symbol_size, sb.length - offset);
+        std::fill(std::copy(_data.begin() + sb.offset + offset, _data.begin() + sb.offset + offset + len, symbol.begin()),
+                  symbol.end(), 0);
+        const uint8_t* from = symbol.data();
+        const uint8_t* to = from + _symbol_size;
+        decoder.add_symbol(from, to, esi);
+    }
+    for (size_t i = 0; i < st.extra_esi.size(); ++i) {
+        const uint8_t* from = st.extra_symbols.data() + i * _symbol_size;
+        const uint8_t* to = from + _symbol_size;
+        decoder.add_symbol(from, to, st.extra_esi[i]);
+    }
+    st.ready = false;
+    st.retry_at = st.received + 1;
+    _blocks_ready--;
+    _rank_deficits++;
+}
+
+// ===================================================================
+// Content hash
+// ===================================================================
+void FecDecoder::advanceHash()
+{
+    while (_hash_block < _blocks.size()) {
+        const SourceBlock& sb = _blocks[_hash_block];
+        const BlockState& st = _state[_hash_block];
+        const uint64_t end = sb.offset + sb.length;
+        if (st.decoded) {
+            _hasher.update(_data.data() + _hash_cursor, static_cast<size_t>(end - _hash_cursor));
+            _hash_cursor = end;
+        } else {
+            // 복원 전 블록: 앞에서부터 연속으로 도착한 source symbol까지만
+            while (_hash_cursor < end) {
+                uint32_t esi = static_cast<uint32_t>((_hash_cursor - sb.offset) / _symbol_size);
+                if (!testBit(st.bitmap_base + esi)) return;
+                uint64_t symbol_end = std::min<uint64_t>(sb.offset + static_cast<uint64_t>(esi + 1) * _symbol_size, end);
+                _hasher.update(_data.data() + _hash_cursor, static_cast<size_t>(symbol_end - _hash_cursor));
+                _hash_cursor = symbol_end;
+            }
+        }
+        if (++_hash_block < _blocks.size()) _hash_marks[_hash_block] = _hasher;
+    }
+}
+
+void FecDecoder::setExpectedHash(uint64_t hash)
+{
+    _has_expected_hash = true;
+    _expected_hash = hash;
+}
+
+FecDecoder::HashStatus FecDecoder::hashStatus() const
+{
+    if (!_has_expected_hash) return HashStatus::UNKNOWN;
+    if (_hash_cursor < _transfer_length) return HashStatus::PENDING;
+    return _hasher.digest() == _expected_hash ? HashStatus::MATCH : HashStatus::MISMATCH;
+}
+
+size_t FecDecoder::reopenBlocks()
+{
+    // 손상된 심볼이 섞인 행렬 디코딩이 가장 흔한 원인 -> 그 블록만 다시 받음
+    std::vector<size_t> reopen;
+    for (size_t b = 0; b < _blocks.size(); ++b) {
+        if (_state[b].decoded && !_state[b].fast_path) reopen.push_back(b);
+    }
+    if (reopen.empty()) {
+        for (size_t b = 0; b < _blocks.size(); ++b) {
+            if (_state[b].decoded) reopen.push_back(b);
+        }
+    }
+    if (reopen.empty()) return 0;
+    _hash_mismatches++;
+
+    for (size_t b : reopen) {
+        const SourceBlock& sb = _blocks[b];
+        BlockState& st = _state[b];
+        _decoders[b].reset(new Decoder(sb.block, _symbol_size, Decoder::Report::COMPLETE));
+        for (uint32_t esi = 0; esi < sb.min_symbols; ++esi) {
+            size_t bit = st.bitmap_base + esi;
+            _bitmap[bit >> 6] &= ~(uint64_t(1) << (bit & 63));
+        }
+        _valid_bytes -= sb.length;
+        _received -= st.received;
+        _blocks_ready--;
+        _blocks_decoded--;
+        if (st.fast_path) _fast_path_blocks--;
+
+        BlockState fresh;
+        fresh.bitmap_base = st.bitmap_base;
+        fresh.esi_end = st.esi_end;
+        st = fresh;
+    }
+
+    // 가장 앞의 되돌린 블록 시작 상태로 hash 되돌림
+    if (reopen[0] < _hash_block || _hash_cursor > _blocks[reopen[0]].offset) {
+        _hash_block = reopen[0];
+        _hasher = _hash_marks[_hash_block];
+        _hash_cursor = _blocks[_hash_block].offset;
+    }
+    return reopen.size();
+}
+
+std::vector<ByteRange> FecDecoder::validRanges() const
+{
+    std::vector<ByteRange> ranges;
+    auto push = [&](uint64_t offset, uint64_t len) {
+        if (!ranges.empty() && ranges.back().offset + ranges.back().length == offset) ranges.back().length += len;
+        else ranges.push_back(ByteRange{ offset, len });
+    };
+    for (size_t b = 0; b < _blocks.size(); ++b) {
+        if (_state[b].decoded) push(_blocks[b].offset, _blocks[b].length);
+        else forEachRun(b, true, push);
+    }
+    return ranges;
+}
@@ -0,0 +1,48 @@
+#include "Feedback.hpp"
+#include "Packetizer.hpp"
+#include <algorithm>
+#include <initializer_list>
+
+static_assert(FEEDBACK_MAX_TEXT == DEFAULT_LORA_MTU, "feedback frames are sent with the same AT+SEND limit");
+
+std::vector<uint8_t> encode_feedback(const Feedback& fb)
+{
+    size_t count = (fb.type == FeedbackType::NEED) ? std::min(fb.needs.size(), FEEDBACK_MAX_BLOCKS) : 0;
+    std::vector<uint8_t> out;
+    out.reserve(3 + 3 * count + 8);
+    out.push_back(FEEDBACK_MAGIC);
+    out.push_back(static_cast<uint8_t>(fb.type));
+    out.push_back(static_cast<uint8_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        out.push_back(fb.needs[i].sbn);
+        out.push_back(static_cast<uint8_t>(fb.needs[i].more >> 8));
+        out.push_back(static_cast<uint8_t>(fb.needs[i].more & 0xFF));
+    }
+    for (uint32_t v : { fb.received, fb.expected }) {
+        for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<uint8_t>(v >> shift));
+    }
+    return out;
+}
+
+bool parse_feedback(const uint8_t* data, size_t len, Feedback& out)
+{
+    if (len < 3 || data[0] != FEEDBACK_MAGIC) return false;
+    if (data[1] != static_cast<uint8_t>(FeedbackType::DONE) && data[1] != static_cast<uint8_t>(FeedbackType::NEED)) return false;
+    size_t count = data[2];
+    const size_t needs_end = 3 + 3 * count;
+    if (len != needs_end && len != needs_end + 8) return false;
+
+    out.type = static_cast<FeedbackType>(data[1]);
+    out.needs.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* p = data + 3 + 3 * i;
+        out.needs.push_back(BlockNeed{ p[0], static_cast<uint16_t>((p[1] << 8) | p[2]) });
+    }
+    out.received = out.expected = 0;
+    if (len == needs_end + 8) {
+        const uint8_t* p = data + needs_end;
+        out.received = (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+        out.expected = (static_cast<uint32_t>(p[4]) << 24) | (p[5] << 16) | (p[6] << 8) | p[7];
+    }
+    return true;
+}
@@ -2,35 +2,111 @@
 #include <unistd.h>
 #include <iostream>
 #include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+bool parse_rcv_line(const char* line, size_t len, LoRaFrame& out) {
+    if (len < 5 || std::memcmp(line, "+RCV=", 5) != 0) return false;
+    char* end = nullptr;
+    long address = std::strtol(line + 5, &end, 10);
+    if (*end != ',') return false;
+    long data_len = std::strtol(end + 1, &end, 10);
+    if (*end != ',' || data_len < 0) return false;
+
+    const char* data = end + 1;
+    const char* line_end = line + len;
+    // 길이끼리 비교 (data + data_len은 신뢰할 수 없는 길이로 범위 밖 포인터를 만들 수 있음)
+    if (data > line_end || static_cast<unsigned long>(data_len) >= static_cast<size_t>(line_end - data) ||
+        data[data_len] != ',') {
+        return false;
+    }
+    out.address = static_cast<int>(address);
+    out.data.assign(data, static_cast<size_t>(data_len));
+    out.rssi = static_cast<int>(std::strtol(data + data_len + 1, &end, 10));
+    out.snr = (*end == ',') ? static_cast<int>(std::strtol(end + 1, &end, 10)) : 0;
+    return true;
+}
+
+AtResult AtResponseParser::parseLine(const char* line, size_t len) {
+    if (len >= 3 && std::memcmp(line, "+OK", 3) == 0) return AtResult::OK;
+    if (len >= 5 && std::memcmp(line, "+ERR=", 5) == 0) {
+        _error_code = static_cast<int>(std::strtol(line + 5, nullptr, 10));
+        return AtResult::ERR;
+    }
+    LoRaFrame frame;
+    if (parse_rcv_line(line, len, frame)) _frames.push_back(std::move(frame));
+    return AtResult::NONE;
+}
+
+bool AtResponseParser::popFrame(LoRaFrame& out) {
+    if (_frames.empty()) return false;
+    out = std::move(_frames.front());
+    _frames.pop_front();
+    return true;
+}
 
 LoRaModule::LoRaModule(const std::string& port_name, speed_t baud_rate) : _port(port_name, baud_rate) { sleep(1); }
 bool LoRaModule::checkConnection() {
-    std::string cmd = "AT\r\n";
-    std::vector<uint8_t> cmd_vec(cmd.begin(), cmd.end());
-    _port.write(cmd_vec);
-    usleep(100000);
-    std::vector<uint8_t> buffer;
-    _port.read(buffer);
-    if (!buffer.empty()) {
-        std::string response(buffer.begin(), buffer.end());
-        if (response.find("+OK") != std::string::npos) return true;
-    }
-    return false;
+    if (!sendCommand("AT\r\n")) return false;
+    return waitForResponse(500) == AtResult::OK;
 }
 bool LoRaModule::sendData(const std::string& data, int address) {
-    std::string command_str = "AT+SEND=" + std::to_string(address) + "," + std::to_string(data.length()) + "," + data + "\r\n";
-    std::vector<uint8_t> command_vec(command_str.begin(), command_str.end());
-    _port.write(command_vec);
+    // "AT+SEND=<addr>,<len>," + payload + "\r\n" 을 이어 붙이지 않고 writev로 보냄
+    char prefix[32];
+    int prefix_len = std::snprintf(prefix, sizeof(prefix), "AT+SEND=%d,%zu,", address, data.size());
+    static const char crlf[] = "\r\n";
+    struct iovec iov[3] = {
+        { prefix, static_cast<size_t>(prefix_len) },
+        { const_cast<char*>(data.data()), data.size() },
+        { const_cast<char*>(crlf), 2 },
+    };
+    if (!sendParts(iov, 3, prefix_len + data.size() + 2)) return false;
     return waitForOk();
 }
-bool LoRaModule::waitForOk() {
-    usleep(600000);
-    std::vector<uint8_t> buffer;
-    _port.read(buffer);
-    if (!buffer.empty()) {
-        std::string response(buffer.begin(), buffer.end());
-        if (response.find("+OK") != std::string::npos) return true;
+bool LoRaModule::sendCommand(const std::string& command) {
+    struct iovec iov = { const_cast<char*>(command.data()), command.size() };
+    return sendParts(&iov, 1, command.size());
+}
+bool LoRaModule::sendParts(const struct iovec* iov, int count, size_t total) {
+    // 이전 명령의 늦은 응답이 이번 명령의 응답으로 읽히지 않도록 이미 도착한 줄을 비움
+    //  - +RCV는 버리지 않고 frame queue에 남김 (송신 중에 도착한 feedback 등)
+    LineView line;
+    while (_port.readLine(line, 0)) _parser.parseLine(line.data, line.size);
+    _parser.reset();
+    return _port.writev(iov, count) == static_cast<ssize_t>(total);
+}
+AtResult LoRaModule::waitForResponse(int timeout_ms) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    LineView line;
+    for (;;) {
+        // deadline이 지나도 이미 도착한 줄은 읽음 (timeout_ms == 0: poll 한 번)
+        int remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+        if (!_port.readLine(line, std::max(remaining, 0))) return AtResult::TIMEOUT;
+        AtResult result = _parser.parseLine(line.data, line.size);
+        if (result != AtResult::NONE) return result;
     }
-    std::cerr << "Error or no response from module." << std::endl;
+}
+bool LoRaModule::receive(LoRaFrame& out, int timeout_ms) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    LineView line;
+    for (;;) {
+        // 수신 모드에서는 +OK/+ERR 응답을 건너뛰고 +RCV만 꺼냄
+        if (_parser.popFrame(out)) return true;
+
+        int remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+        if (!_port.readLine(line, std::max(remaining, 0))) return false;
+        _parser.parseLine(line.data, line.size);
+    }
+}
+bool LoRaModule::waitForOk() {
+    AtResult result = waitForResponse(_response_timeout_ms);
+    if (result == AtResult::OK) return true;
+    if (result == AtResult::ERR) std::cerr << "Module returned +ERR=" << _parser.errorCode() << std::endl;
+    else std::cerr << "Error or no response from module." << std::endl;
     return false;
 }
@@ -0,0 +1,69 @@
+#include "LoRaTxQueue.hpp"
+
+LoRaTxQueue::LoRaTxQueue(LoRaModule& module, int address, size_t capacity)
+    : _module(module), _address(address), _capacity(capacity > 0 ? capacity : 1)
+{
+    _worker = std::thread(&LoRaTxQueue::run, this);
+}
+
+LoRaTxQueue::~LoRaTxQueue() { close(); }
+
+bool LoRaTxQueue::push(std::string payload)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_full.wait(lock, [this] { return _closed || _queue.size() < _capacity; });
+    if (_closed) return false;
+    _queue.push_back(std::move(payload));
+    if (_queue.size() > _stats.max_depth) _stats.max_depth = _queue.size();
+    _not_empty.notify_one();
+    return true;
+}
+
+void LoRaTxQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+    }
+    _not_empty.notify_all();
+    _not_full.notify_all();
+    if (_worker.joinable()) _worker.join();
+}
+
+LoRaTxQueue::Stats LoRaTxQueue::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Stats s = _stats;
+    s.depth = _queue.size();
+    if (_started) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start_time).count();
+        if (elapsed > 0.0) s.packets_per_sec = static_cast<double>(s.sent) / elapsed;
+    }
+    return s;
+}
+
+void LoRaTxQueue::run()
+{
+    for (;;) {
+        std::string payload;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _not_empty.wait(lock, [this] { return _closed || !_queue.empty(); });
+            // close() 후에도 남은 패킷은 모두 보냄
+            if (_queue.empty()) return;
+            payload = std::move(_queue.front());
+            _queue.pop_front();
+            if (!_started) {
+                _started = true;
+                _start_time = std::chrono::steady_clock::now();
+            }
+        }
+        _not_full.notify_one();
+
+        bool ok = _module.sendData(payload, _address);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (ok) _stats.sent++;
+        else _stats.failed++;
+    }
+}
@@ -0,0 +1,188 @@
+#include "LossEstimator.hpp"
+#include "FecBlocks.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// ===================================================================
+// Estimator (file: "<address> <loss> <reports> <transfers> <successes>" 한 줄씩)
+// ===================================================================
+bool LossEstimator::load(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) return true;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream is(line);
+        int address;
+        LinkEstimate e;
+        if (!(is >> address >> e.loss >> e.reports >> e.transfers >> e.successes)) {
+            std::cerr << "[Warning] Ignoring malformed line in " << path << ": " << line << std::endl;
+            continue;
+        }
+        _links[address] = e;
+    }
+    return true;
+}
+
+bool LossEstimator::save(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+    out << "# address loss reports transfers successes" << std::endl;
+    for (const auto& kv : _links) {
+        const LinkEstimate& e = kv.second;
+        out << kv.first << " " << e.loss << " " << e.reports << " " << e.transfers << " " << e.successes << std::endl;
+    }
+    return static_cast<bool>(out);
+}
+
+double LossEstimator::update(int address, uint32_t received, uint32_t expected)
+{
+    LinkEstimate& e = _links[address];
+    if (expected == 0) return e.loss;
+    double sample = 1.0 - std::min(1.0, static_cast<double>(received) / expected);
+    // 첫 report는 그대로 사용 (사전값 0으로 끌려 내려가지 않도록)
+    e.loss = (e.reports == 0) ? sample : (1.0 - _alpha) * e.loss + _alpha * sample;
+    e.reports++;
+    return e.loss;
+}
+
+void LossEstimator::recordOutcome(int address, bool success)
+{
+    LinkEstimate& e = _links[address];
+    e.transfers++;
+    if (success) e.successes++;
+}
+
+LinkEstimate LossEstimator::get(int address) const
+{
+    auto it = _links.find(address);
+    return it == _links.end() ? LinkEstimate() : it->second;
+}
+
+// ===================================================================
+// Repair count
+// ===================================================================
+double decode_success_probability(uint32_t k, uint32_t repair, double loss)
+{
+    const uint32_t n = k + repair;
+    if (loss <= 0.0) return 1.0 - std::pow(0.01, repair + 1.0);    // 전부 도착 (h = repair)
+    if (loss >= 1.0) return 0.0;
+
+    // P(m개 도착) = C(n, m) (1-p)^m p^(n-m), log-space로 계산 (큰 K에서도 underflow 없음)
+    const double log_q = std::log(1.0 - loss);
+    const double log_p = std::log(loss);
+    const double log_n_fact = std::lgamma(n + 1.0);
+    double success = 0.0;
+    for (uint32_t m = k; m <= n; ++m) {
+        double log_pm = log_n_fact - std::lgamma(m + 1.0) - std::lgamma(n - m + 1.0) + m * log_q + (n - m) * log_p;
+        double fail = std::pow(0.01, static_cast<double>(m - k + 1));
+        success += std::exp(log_pm) * (1.0 - fail);
+    }
+    return std::min(1.0, success);
+}
+
+OverheadChoice choose_overhead(const LossEstimator& estimator, int address, uint32_t k,
+                               double target, double max_overhead_ratio)
+{
+    OverheadChoice c;
+    if (!estimator.has(address) || k == 0) {
+        c.repair = repair_symbol_count(k, DEFAULT_OVERHEAD_RATIO);
+        return c;
+    }
+    c.estimated = true;
+    c.loss = estimator.get(address).loss;
+
+    // 성공 확률은 repair 수에 대해 단조 증가 -> 이진 탐색
+    uint32_t lo = 0;
+    uint32_t hi = static_cast<uint32_t>(std::ceil(k * max_overhead_ratio / 100.0));
+    if (decode_success_probability(k, hi, c.loss) >= target) {
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (decode_success_probability(k, mid, c.loss) >= target) hi = mid;
+            else lo = mid + 1;
+        }
+    }
+    c.repair = hi;
+    c.overhead_ratio = 100.0 * c.repair / k;
+    c.success = decode_success_probability(k, c.repair, c.loss);
+    return c;
+}
+
+OverheadChoice choose_transfer_overhead(const LossEstimator& estimator, int address, const std::vector<SourceBlock>& blocks,
+                                        double target, double max_overhead_ratio)
+{
+    OverheadChoice c;
+    c.num_blocks = blocks.size();
+    const uint32_t k0 = blocks.empty() ? 0 : static_cast<uint32_t>(blocks[0].block);
+    if (!estimator.has(address) || blocks.empty()) {
+        c.repair = repair_symbol_count(k0, DEFAULT_OVERHEAD_RATIO);
+        return c;
+    }
+
+    // 블록별 목표: target^(1/Z), K가 같은 블록은 한 번만 계산 (KL / KS -> 보통 1~2개)
+    const double block_target = std::pow(target, 1.0 / blocks.size());
+    std::map<uint32_t, OverheadChoice> per_k;
+    double ratio = 0.0;
+    for (const auto& sb : blocks) {
+        uint32_t k = static_cast<uint32_t>(sb.block);
+        if (per_k.count(k)) continue;
+        per_k[k] = choose_overhead(estimator, address, k, block_target, max_overhead_ratio);
+        ratio = std::max(ratio, per_k[k].overhead_ratio);
+    }
+    c.estimated = true;
+    c.loss = estimator.get(address).loss;
+    c.overhead_ratio = ratio;
+    c.repair = repair_symbol_count(k0, ratio);
+
+    // 인코더가 실제로 만들 repair 수(ceil(K * ratio / 100))로 전송 전체 성공 확률
+    double log_success = 0.0;
+    for (const auto& sb : blocks) {
+        uint32_t k = static_cast<uint32_t>(sb.block);
+        log_success += std::log(std::max(decode_success_probability(k, repair_symbol_count(k, ratio), c.loss), 1e-300));
+    }
+    c.success = std::exp(log_success);
+    return c;
+}
+
+double adaptive_overhead_ratio(const std::string& estimator_path, int address, const std::vector<SourceBlock>& blocks,
+                               double target, bool verbose)
+{
+    LossEstimator estimator;
+    estimator.load(estimator_path);
+    OverheadChoice c = choose_transfer_overhead(estimator, address, blocks, target);
+    if (!verbose) return c.overhead_ratio;
+
+    LinkEstimate e = estimator.get(address);
+    uint32_t k = blocks.empty() ? 0 : static_cast<uint32_t>(blocks[0].block);
+    std::cout << " Overhead: " << c.overhead_ratio << "% (" << c.repair << " repair symbols for K=" << k;
+    if (c.num_blocks > 1) std::cout << ", " << c.num_blocks << " blocks";
+    std::cout << ")";
+    if (c.estimated) {
+        std::cout << ", loss estimate " << 100.0 * c.loss << "% for address " << address << " (" << e.reports << " reports)"
+                  << ", predicted success " << 100.0 * c.success << "%";
+        if (c.num_blocks > 1) std::cout << " for all " << c.num_blocks << " blocks";
+        std::cout << " (target " << 100.0 * target << "%)";
+    } else {
+        std::cout << ", no loss estimate for address " << address << " in " << estimator_path << " -> default";
+    }
+    std::cout << std::endl;
+    if (e.transfers > 0) {
+        std::cout << " Observed success: " << e.successes << "/" << e.transfers << " transfers ("
+                  << 100.0 * e.successes / e.transfers << "%)" << std::endl;
+    }
+    return c.overhead_ratio;
+}
+
+double adaptive_overhead_ratio(const std::string& estimator_path, int address, size_t transfer_length,
+                               uint16_t symbol_size, uint32_t min_blocks, double target, bool verbose)
+{
+    return adaptive_overhead_ratio(estimator_path, address, partition_source_blocks(transfer_length, symbol_size, min_blocks),
+                                   target, verbose);
+}
@@ -0,0 +1,226 @@
+#include "MatrixCache.hpp"
+#include "XxHash64.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RaptorQ = RaptorQ__v1;
+
+static const uint8_t MATRIX_MAGIC[4] = { 'R', 'Q', 'G', 'M' };
+
+static void put_be(uint8_t* p, uint64_t v, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) p[i] = static_cast<uint8_t>(v >> (8 * (n - 1 - i)));
+}
+
+static uint64_t get_be(const uint8_t* p, size_t n)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+// RFC 6330 5.7: GF(256), x^8 + x^4 + x^3 + x^2 + 1
+//  - 256 x 256 곱셈표 (64 KiB) -> 계수 하나에 대해 byte마다 lookup 한 번
+static const uint8_t* gf256_mul_row(uint8_t c)
+{
+    struct Table {
+        uint8_t mul[256][256];
+        Table()
+        {
+            uint8_t exp[510];
+            int log[256] = { 0 };
+            unsigned x = 1;
+            for (int i = 0; i < 255; ++i) {
+                exp[i] = exp[i + 255] = static_cast<uint8_t>(x);
+                log[x] = i;
+                x <<= 1;
+                if (x & 0x100) x ^= 0x11D;
+            }
+            for (int a = 0; a < 256; ++a) {
+                for (int b = 0; b < 256; ++b) mul[a][b] = (a && b) ? exp[log[a] + log[b]] : 0;
+            }
+        }
+    };
+    static const Table table;
+    return table.mul[c];
+}
+
+// ==========================================================
+// RepairMatrix
+// ==========================================================
+RepairMatrix::RepairMatrix(uint32_t num_source_symbols, uint32_t rows, std::vector<uint8_t> coefficients)
+    : _k(num_source_symbols), _rows(rows), _owned(std::move(coefficients)), _g(_owned.data()) {}
+
+RepairMatrix::RepairMatrix(uint32_t num_source_symbols, uint32_t rows, const uint8_t* mapped, void* map_base, size_t map_length)
+    : _k(num_source_symbols), _rows(rows), _g(mapped), _map_base(map_base), _map_length(map_length) {}
+
+RepairMatrix::~RepairMatrix()
+{
+    if (_map_base) munmap(_map_base, _map_length);
+}
+
+void RepairMatrix::encodeRepair(uint32_t r, const uint8_t* block, uint16_t symbol_size, uint8_t* out) const
+{
+    std::memset(out, 0, symbol_size);
+    const uint8_t* g = row(r);
+    for (uint32_t i = 0; i < _k; ++i) {
+        uint8_t c = g[i];
+        if (c == 0) continue;
+        const uint8_t* src = block + static_cast<size_t>(i) * symbol_size;
+        if (c == 1) {
+            for (uint16_t t = 0; t < symbol_size; ++t) out[t] ^= src[t];
+        } else {
+            const uint8_t* mul = gf256_mul_row(c);
+            for (uint16_t t = 0; t < symbol_size; ++t) out[t] ^= mul[src[t]];
+        }
+    }
+}
+
+// ==========================================================
+// MatrixCache
+// ==========================================================
+MatrixCache::MatrixCache(std::string dir) : _dir(std::move(dir)) {}
+
+std::string MatrixCache::path(uint32_t k) const
+{
+    return _dir + "/k" + std::to_string(k) + ".rqg";
+}
+
+MatrixCache::Stats MatrixCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+std::string MatrixCache::summary() const
+{
+    Stats s = stats();
+    std::string text = "hits " + std::to_string(s.hits) + " (" + std::to_string(s.loaded) + " from disk), extracted " +
+                       std::to_string(s.extracted);
+    if (s.invalid) text += ", invalid files " + std::to_string(s.invalid);
+    if (s.skipped) text += ", not cached (large K) " + std::to_string(s.skipped);
+    return text;
+}
+
+std::shared_ptr<const RepairMatrix> MatrixCache::get(RaptorQ::Block_Size block, uint32_t rows)
+{
+    const uint32_t k = static_cast<uint32_t>(block);
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // 추출 버퍼(K * K)와 G(rows * K) 모두 상한 안이어야 함
+    if (static_cast<uint64_t>(k) * k > MATRIX_CACHE_MAX_BYTES ||
+        static_cast<uint64_t>(std::max(rows, 1u)) * k > MATRIX_CACHE_MAX_BYTES) {
+        _stats.skipped++;
+        return nullptr;
+    }
+
+    auto it = _matrices.find(k);
+    if (it != _matrices.end() && it->second->rows() >= rows) {
+        _stats.hits++;
+        return it->second;
+    }
+
+    std::shared_ptr<const RepairMatrix> matrix;
+    if (it == _matrices.end() && !_dir.empty()) matrix = load(k, rows);
+    if (matrix) {
+        _stats.hits++;
+        _stats.loaded++;
+    } else {
+        matrix = extract(block, rows);
+        if (!matrix) return nullptr;
+        _stats.extracted++;
+        if (!_dir.empty()) store(*matrix);
+    }
+    _matrices[k] = matrix;
+    return matrix;
+}
+
+std::shared_ptr<const RepairMatrix> MatrixCache::load(uint32_t k, uint32_t rows)
+{
+    int fd = open(path(k).c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < MATRIX_CACHE_HEADER_SIZE) {
+        close(fd);
+        _stats.invalid++;
+        return nullptr;
+    }
+    size_t length = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return nullptr;
+
+    const uint8_t* header = static_cast<const uint8_t*>(base);
+    const uint8_t* g = header + MATRIX_CACHE_HEADER_SIZE;
+    uint32_t file_k = static_cast<uint32_t>(get_be(header + 8, 4));
+    uint32_t file_rows = static_cast<uint32_t>(get_be(header + 12, 4));
+    bool valid = std::memcmp(header, MATRIX_MAGIC, 4) == 0 && get_be(header + 4, 2) == MATRIX_CACHE_VERSION &&
+                 file_k == k && length == MATRIX_CACHE_HEADER_SIZE + static_cast<size_t>(file_rows) * k &&
+                 get_be(header + 16, 8) == xxh64(g, length - MATRIX_CACHE_HEADER_SIZE, xxh64(header, 16));
+    if (!valid) {
+        _stats.invalid++;
+        munmap(base, length);
+        return nullptr;
+    }
+    // 행이 부족하면 더 많이 다시 추출 (파일은 store()가 교체)
+    if (file_rows < rows) {
+        munmap(base, length);
+        return nullptr;
+    }
+    return std::make_shared<RepairMatrix>(k, file_rows, g, base, length);
+}
+
+std::shared_ptr<const RepairMatrix> MatrixCache::extract(RaptorQ::Block_Size block, uint32_t rows)
+{
+    using InputIt = std::vector<uint8_t>::iterator;
+    using OutputIt = std::vector<uint8_t>::iterator;
+    using Encoder = RaptorQ::Encoder<InputIt, OutputIt>;
+
+    const uint32_t k = static_cast<uint32_t>(block);
+    // overhead를 조금 바꿀 때마다 다시 추출하지 않도록 최소 K행 (상한 안에서)
+    rows = std::max(rows, std::min<uint32_t>(k, static_cast<uint32_t>(MATRIX_CACHE_MAX_BYTES / k)));
+
+    // T = K, source i = e_i (i번째 byte만 1)
+    std::vector<uint8_t> identity(static_cast<size_t>(k) * k, 0);
+    for (uint32_t i = 0; i < k; ++i) identity[static_cast<size_t>(i) * k + i] = 1;
+    Encoder encoder(block, k);
+    encoder.set_data(identity.begin(), identity.end());
+    if (!encoder.compute_sync()) return nullptr;
+
+    std::vector<uint8_t> g(static_cast<size_t>(rows) * k);
+    auto repair_it = encoder.begin_repair();
+    for (uint32_t r = 0; r < rows; ++r, ++repair_it) {
+        auto out_it = g.begin() + static_cast<size_t>(r) * k;
+        (*repair_it)(out_it, out_it + k);
+    }
+    return std::make_shared<RepairMatrix>(k, rows, std::move(g));
+}
+
+void MatrixCache::store(const RepairMatrix& matrix)
+{
+    const uint32_t k = matrix.numSourceSymbols();
+    const size_t g_len = static_cast<size_t>(matrix.rows()) * k;
+
+    uint8_t header[MATRIX_CACHE_HEADER_SIZE] = { 0 };
+    std::memcpy(header, MATRIX_MAGIC, 4);
+    put_be(header + 4, MATRIX_CACHE_VERSION, 2);
+    put_be(header + 8, k, 4);
+    put_be(header + 12, matrix.rows(), 4);
+    put_be(header + 16, xxh64(matrix.row(0), g_len, xxh64(header, 16)), 8);
+
+    // 임시 파일 + rename -> 다른 프로세스가 쓰는 중인 파일을 읽지 않음 (기존 mmap도 그대로 유효)
+    mkdir(_dir.c_str(), 0755);
+    std::string final_path = path(k);
+    std::string tmp_path = final_path + ".tmp" + std::to_string(getpid());
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+    bool ok = write(fd, header, sizeof(header)) == static_cast<ssize_t>(sizeof(header)) &&
+              write(fd, matrix.row(0), g_len) == static_cast<ssize_t>(g_len);
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(tmp_path.c_str(), final_path.c_str()) != 0) unlink(tmp_path.c_str());
+}
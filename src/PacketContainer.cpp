@@ -0,0 +1,151 @@
+#include "PacketContainer.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+
+static void put_le(uint8_t* p, uint64_t v, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t* p, size_t n)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+// magic(4) version(2) T(2) F(8) K(4) Z(2) record(2) count(4) reserved(4)
+// v2: + flags(4, bit0 = hash) content_hash(8) reserved(4)
+static void serialize_header(const ContainerHeader& h, uint8_t* out)
+{
+    std::memset(out, 0, CONTAINER_HEADER_SIZE);
+    std::memcpy(out, CONTAINER_MAGIC, 4);
+    put_le(out + 4, h.version, 2);
+    put_le(out + 6, h.symbol_size, 2);
+    put_le(out + 8, h.transfer_length, 8);
+    put_le(out + 16, h.num_source_symbols, 4);
+    put_le(out + 20, h.num_blocks, 2);
+    put_le(out + 22, h.record_size, 2);
+    put_le(out + 24, h.num_records, 4);
+    put_le(out + 32, h.has_hash ? 1 : 0, 4);
+    put_le(out + 36, h.content_hash, 8);
+}
+
+// v1 헤더(32B)는 content hash 없음, length = mmap 크기 (v2 헤더가 다 들어 있는지 확인)
+static bool parse_header(const uint8_t* in, size_t length, ContainerHeader& h)
+{
+    if (std::memcmp(in, CONTAINER_MAGIC, 4) != 0) return false;
+    h.version = static_cast<uint16_t>(get_le(in + 4, 2));
+    h.symbol_size = static_cast<uint16_t>(get_le(in + 6, 2));
+    h.transfer_length = get_le(in + 8, 8);
+    h.num_source_symbols = static_cast<uint32_t>(get_le(in + 16, 4));
+    h.num_blocks = static_cast<uint16_t>(get_le(in + 20, 2));
+    h.record_size = static_cast<uint16_t>(get_le(in + 22, 2));
+    h.num_records = static_cast<uint32_t>(get_le(in + 24, 4));
+    h.has_hash = false;
+    h.content_hash = 0;
+    if (h.version == CONTAINER_VERSION) {
+        if (length < CONTAINER_HEADER_SIZE) return false;
+        h.has_hash = (get_le(in + 32, 4) & 1) != 0;
+        h.content_hash = get_le(in + 36, 8);
+    } else if (h.version != 1) {
+        return false;
+    }
+    return h.symbol_size != 0 && h.record_size > h.symbol_size;
+}
+
+// ===================================================================
+// Writer
+// ===================================================================
+ContainerWriter::~ContainerWriter() { if (_out.is_open()) close(); }
+
+bool ContainerWriter::open(const std::string& path, const ContainerHeader& header)
+{
+    _header = header;
+    _header.num_records = 0;
+    _out.open(path, std::ios::binary | std::ios::trunc);
+    if (!_out) return false;
+
+    uint8_t raw[CONTAINER_HEADER_SIZE];
+    serialize_header(_header, raw);
+    _out.write(reinterpret_cast<const char*>(raw), sizeof(raw));
+    return static_cast<bool>(_out);
+}
+
+bool ContainerWriter::append(const uint8_t* record, size_t size)
+{
+    if (size != _header.record_size) return false;
+    _out.write(reinterpret_cast<const char*>(record), size);
+    ++_header.num_records;
+    return static_cast<bool>(_out);
+}
+
+bool ContainerWriter::close()
+{
+    if (!_out.is_open()) return false;
+    uint8_t raw[CONTAINER_HEADER_SIZE];
+    serialize_header(_header, raw);
+    _out.seekp(0);
+    _out.write(reinterpret_cast<const char*>(raw), sizeof(raw));
+    bool ok = static_cast<bool>(_out);
+    _out.close();
+    return ok;
+}
+
+// ===================================================================
+// Reader (mmap)
+// ===================================================================
+ContainerReader::~ContainerReader() { close(); }
+
+bool ContainerReader::isContainer(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    return in.read(magic, 4) && std::memcmp(magic, CONTAINER_MAGIC, 4) == 0;
+}
+
+bool ContainerReader::open(const std::string& path)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < CONTAINER_V1_HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    _length = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // mapping은 fd를 닫아도 유지됨
+    if (map == MAP_FAILED) {
+        _length = 0;
+        return false;
+    }
+    _data = static_cast<const uint8_t*>(map);
+    madvise(map, _length, MADV_SEQUENTIAL);
+
+    if (!parse_header(_data, _length, _header)) {
+        std::cerr << "[ERROR] Invalid packet container header: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // 끝이 잘린 파일은 완전한 레코드까지만 사용
+    _header_size = (_header.version == 1) ? CONTAINER_V1_HEADER_SIZE : CONTAINER_HEADER_SIZE;
+    size_t available = (_length - _header_size) / _header.record_size;
+    _num_records = (_header.num_records == 0 || _header.num_records > available) ? available : _header.num_records;
+    return true;
+}
+
+void ContainerReader::close()
+{
+    if (_data) munmap(const_cast<uint8_t*>(_data), _length);
+    _data = nullptr;
+    _length = 0;
+    _num_records = 0;
+}
@@ -0,0 +1,102 @@
+#include "Packetizer.hpp"
+#include "Base64Simd.hpp"
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+Packing estimate_packing(size_t transfer_length, double overhead_ratio, uint16_t symbol_size,
+                         uint8_t symbols_per_frame, const LoRaParams& params, uint32_t min_blocks)
+{
+    Packing p;
+    p.symbol_size = symbol_size;
+    p.symbols_per_frame = symbols_per_frame;
+    if (symbols_per_frame == 0) return p;
+
+    std::vector<SourceBlock> blocks = partition_source_blocks(transfer_length, symbol_size, min_blocks);
+    if (blocks.empty()) {
+        p.symbols_per_frame = 0;
+        return p;
+    }
+
+    const double full_airtime = lora_airtime_ms(params, base64_encoded_size(FRAME_HEADER_SIZE + symbols_per_frame * symbol_size));
+    for (const auto& sb : blocks) {
+        // 인코더와 같은 repair 수, 프레임은 블록 경계를 넘지 않음
+        uint32_t k = static_cast<uint32_t>(sb.block);
+        uint32_t packets = k + repair_symbol_count(k, overhead_ratio);
+        uint32_t full = packets / symbols_per_frame;
+        uint32_t rest = packets % symbols_per_frame;
+        p.frames += full + (rest ? 1 : 0);
+        p.airtime_ms += full * full_airtime;
+        if (rest) p.airtime_ms += lora_airtime_ms(params, base64_encoded_size(FRAME_HEADER_SIZE + rest * symbol_size));
+    }
+    return p;
+}
+
+Packing choose_packing(size_t transfer_length, double overhead_ratio, size_t mtu_chars,
+                       const LoRaParams& params, uint32_t min_blocks)
+{
+    Packing best;
+    best.symbols_per_frame = 0;
+    const size_t mtu_bytes = mtu_chars / 4 * 3;     // Base64 4문자 = 3바이트
+    if (mtu_bytes <= FRAME_HEADER_SIZE) return best;
+
+    const size_t max_payload = mtu_bytes - FRAME_HEADER_SIZE;
+    for (size_t t = 1; t <= max_payload && t <= UINT16_MAX; ++t) {
+        size_t n = std::min<size_t>(max_payload / t, UINT8_MAX);
+        Packing p = estimate_packing(transfer_length, overhead_ratio, static_cast<uint16_t>(t),
+                                     static_cast<uint8_t>(n), params, min_blocks);
+        if (p.symbols_per_frame == 0) continue;
+        if (best.symbols_per_frame == 0 || p.airtime_ms < best.airtime_ms) best = p;
+    }
+    return best;
+}
+
+bool parse_frame(const uint8_t* frame, size_t len, FrameView& out)
+{
+    if (len <= FRAME_HEADER_SIZE || frame[0] == 0) return false;
+    size_t body = len - FRAME_HEADER_SIZE;
+    if (body % frame[0] != 0) return false;
+
+    out.count = frame[0];
+    read_payload_id(frame + 1, out.sbn, out.first_esi);
+    out.symbol_size = static_cast<uint16_t>(body / frame[0]);
+    out.symbols = frame + FRAME_HEADER_SIZE;
+    return out.symbol_size != 0 && out.first_esi + out.count - 1 <= MAX_ESI;
+}
+
+Packetizer::Packetizer(uint16_t symbol_size, uint8_t symbols_per_frame, FrameSink sink)
+    : _symbol_size(symbol_size), _max_symbols(symbols_per_frame > 0 ? symbols_per_frame : 1), _sink(std::move(sink))
+{
+    _frame.reserve(FRAME_HEADER_SIZE + static_cast<size_t>(_max_symbols) * _symbol_size);
+}
+
+bool Packetizer::add(const uint8_t* packet)
+{
+    uint8_t sbn;
+    uint32_t esi;
+    read_payload_id(packet, sbn, esi);
+
+    // 다른 블록이거나 ESI가 이어지지 않으면 새 프레임
+    if (_count > 0 && (sbn != _sbn || esi != _next_esi)) {
+        if (!flush()) return false;
+    }
+    if (_count == 0) {
+        _frame.assign(FRAME_HEADER_SIZE, 0);
+        write_payload_id(_frame.data() + 1, sbn, esi);
+        _sbn = sbn;
+    }
+    _frame.insert(_frame.end(), packet + PAYLOAD_ID_SIZE, packet + PAYLOAD_ID_SIZE + _symbol_size);
+    _count++;
+    _next_esi = esi + 1;
+
+    if (_count == _max_symbols) return flush();
+    return true;
+}
+
+bool Packetizer::flush()
+{
+    if (_count == 0) return true;
+    _frame[0] = _count;
+    _count = 0;
+    return _sink(_frame.data(), _frame.size());
+}
@@ -0,0 +1,51 @@
+#include "ProgressiveFile.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+ProgressiveFile::~ProgressiveFile() { close(); }
+
+bool ProgressiveFile::open(const std::string& path, uint64_t size)
+{
+    close();
+    _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (_fd < 0) {
+        std::cerr << "[ERROR] Cannot open output file " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    // 최종 크기로 미리 늘려 둠 (받지 못한 구간은 0)
+    if (ftruncate(_fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "[ERROR] Cannot resize output file " << path << ": " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    _size = size;
+    _written = 0;
+    return true;
+}
+
+bool ProgressiveFile::write(uint64_t offset, const uint8_t* data, size_t len)
+{
+    if (_fd < 0 || offset + len > _size) return false;
+    while (len > 0) {
+        ssize_t n = ::pwrite(_fd, data, len, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[ERROR] Output write failed at offset " << offset << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        data += n;
+        offset += static_cast<uint64_t>(n);
+        len -= static_cast<size_t>(n);
+        _written += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+void ProgressiveFile::close()
+{
+    if (_fd >= 0) ::close(_fd);
+    _fd = -1;
+}
@@ -0,0 +1,35 @@
+#include "RatelessEncoder.hpp"
+
+RatelessEncoder::RatelessEncoder(std::vector<uint8_t> data, uint16_t symbol_size, uint32_t min_blocks)
+    : _data(std::move(data)), _symbol_size(symbol_size)
+{
+    _blocks = partition_source_blocks(_data.size(), symbol_size, min_blocks);
+    if (_blocks.empty()) return;
+
+    for (const auto& sb : _blocks) {
+        _encoders.emplace_back(new Encoder(sb.block, symbol_size));
+        Encoder& encoder = *_encoders.back();
+        encoder.set_data(_data.begin() + sb.offset, _data.begin() + sb.offset + sb.length);
+        if (!encoder.compute_sync()) return;
+        _next_esi.push_back(static_cast<uint32_t>(sb.block));
+    }
+    _valid = true;
+}
+
+void RatelessEncoder::sourcePacket(uint8_t sbn, uint32_t esi, uint8_t* packet)
+{
+    write_payload_id(packet, sbn, esi);
+    OutputIt out_it = packet + PAYLOAD_ID_SIZE;
+    _encoders[sbn]->encode(out_it, packet + packetSize(), esi);
+}
+
+bool RatelessEncoder::nextRepairPacket(uint8_t sbn, uint8_t* packet)
+{
+    uint32_t esi = _next_esi[sbn];
+    if (esi > MAX_ESI) return false;
+    write_payload_id(packet, sbn, esi);
+    OutputIt out_it = packet + PAYLOAD_ID_SIZE;
+    _encoders[sbn]->encode(out_it, packet + packetSize(), esi);
+    _next_esi[sbn] = esi + 1;
+    return true;
+}
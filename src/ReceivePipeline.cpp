@@ -0,0 +1,201 @@
+#include "ReceivePipeline.hpp"
+#include "Base64Simd.hpp"
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+static int64_t now_ms()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ring이 비어 있을 때: 잠깐 양보하고 그래도 없으면 짧게 잠듦 (busy loop 방지)
+static void backoff(unsigned& idle)
+{
+    if (++idle < 64) std::this_thread::yield();
+    else std::this_thread::sleep_for(std::chrono::microseconds(200));
+}
+
+ReceivePipeline::ReceivePipeline(LoRaModule& module, size_t ring_capacity)
+    : _module(module), _raw(ring_capacity), _packets(ring_capacity) {}
+
+bool ReceivePipeline::run(const PacketConsumer& consumer, int idle_timeout_ms, int report_interval_ms)
+{
+    _stop = false;
+    _done = false;
+    _reader_finished = false;
+    _parser_finished = false;
+    _last_frame_ms = now_ms();
+
+    std::thread reader(&ReceivePipeline::readerLoop, this);
+    std::thread parser(&ReceivePipeline::parserLoop, this);
+    std::thread decoder(&ReceivePipeline::decoderLoop, this, std::cref(consumer));
+
+    // 호출한 thread: idle timeout 감시 + 주기적 보고
+    int64_t next_report = now_ms() + report_interval_ms;
+    while (!_done) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        int64_t now = now_ms();
+        // 아직 ring에 남은 패킷이 있으면 처리가 끝날 때까지 기다림
+        if (now - _last_frame_ms > idle_timeout_ms && _raw.size() == 0 && _packets.size() == 0) {
+            std::cerr << "[FAILURE] No frame for " << idle_timeout_ms / 1000 << " s. Giving up." << std::endl;
+            break;
+        }
+        if (report_interval_ms > 0 && now >= next_report) {
+            Stats s = stats();
+            std::cout << "  [pipeline] frames " << s.frames << ", packets " << s.packets
+                      << ", raw ring " << s.raw_depth << "/" << s.raw_capacity << " (max " << s.raw_high_water << ")"
+                      << ", packet ring " << s.packet_depth << "/" << s.packet_capacity << " (max " << s.packet_high_water << ")"
+                      << ", overruns " << s.overruns << std::endl;
+            next_report = now + report_interval_ms;
+        }
+    }
+
+    _stop = true;
+    reader.join();
+    parser.join();
+    decoder.join();
+    return _done;
+}
+
+ReceivePipeline::Stats ReceivePipeline::stats() const
+{
+    Stats s;
+    s.frames = _frames;
+    s.overruns = _overruns;
+    s.rejected = _rejected;
+    s.packets = _processed;
+    s.raw_depth = _raw.size();
+    s.raw_high_water = _raw.highWater();
+    s.raw_capacity = _raw.capacity();
+    s.packet_depth = _packets.size();
+    s.packet_high_water = _packets.highWater();
+    s.packet_capacity = _packets.capacity();
+    return s;
+}
+
+void ReceivePipeline::send(std::string payload, int address)
+{
+    std::lock_guard<std::mutex> lock(_outbox_mutex);
+    _outbox.emplace_back(std::move(payload), address);
+}
+
+void ReceivePipeline::setIdleHandler(int gap_ms, IdleHandler handler)
+{
+    _idle_gap_ms = gap_ms;
+    _idle_handler = std::move(handler);
+}
+
+// reader thread에서만 호출: +OK를 기다리는 동안 온 +RCV는 LoRaModule의 frame queue에 남음
+void ReceivePipeline::flushOutbox()
+{
+    for (;;) {
+        std::pair<std::string, int> item;
+        {
+            std::lock_guard<std::mutex> lock(_outbox_mutex);
+            if (_outbox.empty()) return;
+            item = std::move(_outbox.front());
+            _outbox.pop_front();
+        }
+        if (!_module.sendData(item.first, item.second)) {
+            std::cerr << "[Warning] Failed to send " << item.first.size() << " chars to address " << item.second << std::endl;
+        }
+    }
+}
+
+// ==========================================================
+// Stage 1: serial -> raw ring (+ outbox -> AT+SEND)
+// ==========================================================
+void ReceivePipeline::readerLoop()
+{
+    LoRaFrame frame;
+    while (!_stop) {
+        flushOutbox();
+        // 짧은 timeout으로 _stop / outbox를 자주 확인
+        if (!_module.receive(frame, 100)) continue;
+        _frames++;
+        _last_frame_ms = now_ms();
+
+        RawSlot* slot = _raw.writeSlot();
+        if (!slot) {
+            _overruns++;
+            continue;
+        }
+        if (frame.data.size() > PIPELINE_MAX_LINE) {
+            _rejected++;
+            continue;
+        }
+        slot->len = static_cast<uint16_t>(frame.data.size());
+        slot->rssi = static_cast<int16_t>(frame.rssi);
+        slot->snr = static_cast<int16_t>(frame.snr);
+        slot->address = frame.address;
+        std::memcpy(slot->data, frame.data.data(), frame.data.size());
+        _raw.commitWrite();
+    }
+    flushOutbox();      // 마지막 feedback (DONE 등)
+    _reader_finished = true;
+}
+
+// ==========================================================
+// Stage 2: raw ring -> Base64 decode -> packet ring
+// ==========================================================
+void ReceivePipeline::parserLoop()
+{
+    unsigned idle = 0;
+    for (;;) {
+        RawSlot* raw = _raw.readSlot();
+        if (!raw) {
+            if (_reader_finished) break;
+            backoff(idle);
+            continue;
+        }
+        PacketSlot* out = _packets.writeSlot();
+        if (!out) {
+            if (_stop) break;
+            backoff(idle);      // decoder가 밀려 있음 -> raw ring에 쌓이게 둠
+            continue;
+        }
+        idle = 0;
+
+        Base64DecodeResult b64 = base64_decode_checked(raw->data, raw->len, out->data, sizeof(out->data));
+        if (b64.status == Base64Status::OK) {
+            out->len = static_cast<uint16_t>(b64.written);
+            out->address = raw->address;
+            _packets.commitWrite();
+        } else {
+            _rejected++;
+        }
+        _raw.commitRead();
+    }
+    _parser_finished = true;
+}
+
+// ==========================================================
+// Stage 3: packet ring -> consumer (add_symbol / 블록 복원)
+// ==========================================================
+void ReceivePipeline::decoderLoop(const PacketConsumer& consumer)
+{
+    unsigned idle = 0;
+    int64_t last_activity = now_ms();
+    while (!_done) {
+        PacketSlot* packet = _packets.readSlot();
+        if (!packet) {
+            if (_parser_finished) break;
+            if (_idle_handler && now_ms() - std::max<int64_t>(last_activity, _last_frame_ms) >= _idle_gap_ms) {
+                _idle_handler();
+                last_activity = now_ms();
+            }
+            backoff(idle);
+            continue;
+        }
+        last_activity = now_ms();
+        idle = 0;
+        bool finished = consumer(packet->data, packet->len, packet->address);
+        _packets.commitRead();
+        _processed++;
+        if (finished) _done = true;
+    }
+}
@@ -1,10 +1,14 @@
 #include "SerialPort.hpp"
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 
-SerialPort::SerialPort(const std::string& port_name, speed_t baud_rate) {
+SerialPort::SerialPort(const std::string& port_name, speed_t baud_rate) : _rx(RX_BUFFER_SIZE) {
     _fd = open(port_name.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
     if (_fd < 0) throw std::runtime_error("Serial port open error: " + port_name);
 
@@ -23,12 +27,120 @@ SerialPort::SerialPort(const std::string& port_name, speed_t baud_rate) {
 SerialPort::~SerialPort() { if (_fd >= 0) close(_fd); }
 ssize_t SerialPort::write(const std::vector<uint8_t>& data) {
     if (_fd < 0) return -1;
-    return ::write(_fd, data.data(), data.size());
+    // O_NDELAY: UART 버퍼가 차면 부분 write -> POLLOUT을 기다렸다가 나머지를 씀
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::write(_fd, data.data() + sent, data.size() - sent);
+        if (n > 0) { sent += static_cast<size_t>(n); continue; }
+        if (n < 0 && errno != EAGAIN && errno != EINTR) return -1;
+        struct pollfd pfd = { _fd, POLLOUT, 0 };
+        if (poll(&pfd, 1, 1000) <= 0) return sent > 0 ? static_cast<ssize_t>(sent) : -1;
+    }
+    return static_cast<ssize_t>(sent);
+}
+ssize_t SerialPort::writev(const struct iovec* iov, int count) {
+    if (_fd < 0) return -1;
+    size_t total = 0;
+    for (int i = 0; i < count; ++i) total += iov[i].iov_len;
+
+    // 부분 write 후에는 남은 조각만 다시 보냄 (iovec 사본을 앞에서부터 소비)
+    struct iovec parts[8];
+    if (count > 8) return -1;
+    std::memcpy(parts, iov, sizeof(struct iovec) * count);
+    struct iovec* cur = parts;
+    int left = count;
+    size_t sent = 0;
+    while (sent < total) {
+        ssize_t n = ::writev(_fd, cur, left);
+        if (n < 0 && errno != EAGAIN && errno != EINTR) return -1;
+        if (n <= 0) {
+            struct pollfd pfd = { _fd, POLLOUT, 0 };
+            if (poll(&pfd, 1, 1000) <= 0) return sent > 0 ? static_cast<ssize_t>(sent) : -1;
+            continue;
+        }
+        sent += static_cast<size_t>(n);
+        size_t consumed = static_cast<size_t>(n);
+        while (left > 0 && consumed >= cur->iov_len) {
+            consumed -= cur->iov_len;
+            ++cur;
+            --left;
+        }
+        if (left > 0) {
+            cur->iov_base = static_cast<char*>(cur->iov_base) + consumed;
+            cur->iov_len -= consumed;
+        }
+    }
+    return static_cast<ssize_t>(sent);
 }
 ssize_t SerialPort::read(std::vector<uint8_t>& buffer) {
     if (_fd < 0) return -1;
+    // 줄 버퍼에 남아 있는 데이터가 있으면 그것부터 돌려줌
+    if (_rx_end > _rx_start) {
+        buffer.assign(_rx.begin() + _rx_start, _rx.begin() + _rx_end);
+        _rx_start = _rx_end = _rx_scanned = 0;
+        return static_cast<ssize_t>(buffer.size());
+    }
     char temp_buf[256];
     ssize_t bytes_read = ::read(_fd, temp_buf, sizeof(temp_buf));
     if (bytes_read > 0) buffer.assign(temp_buf, temp_buf + bytes_read);
     return bytes_read;
 }
+bool SerialPort::waitReadable(int timeout_ms) {
+    if (_fd < 0) return false;
+    struct pollfd pfd = { _fd, POLLIN, 0 };
+    int ret;
+    do { ret = poll(&pfd, 1, timeout_ms); } while (ret < 0 && errno == EINTR);
+    return ret > 0 && (pfd.revents & POLLIN);
+}
+ssize_t SerialPort::readSome(uint8_t* buffer, size_t capacity) {
+    if (_fd < 0) return -1;
+    ssize_t n = ::read(_fd, buffer, capacity);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) return 0;
+    return n;
+}
+bool SerialPort::fillBuffer() {
+    if (_rx_end == _rx.size()) {
+        if (_rx_start == 0) {
+            // 버퍼보다 긴 줄: 버리고 다시 시작 (AT 응답은 최대 수백 바이트)
+            _rx_start = _rx_end = _rx_scanned = 0;
+        } else {
+            std::memmove(_rx.data(), _rx.data() + _rx_start, _rx_end - _rx_start);
+            _rx_end -= _rx_start;
+            _rx_scanned -= _rx_start;
+            _rx_start = 0;
+        }
+    }
+    ssize_t n = readSome(reinterpret_cast<uint8_t*>(_rx.data() + _rx_end), _rx.size() - _rx_end);
+    if (n < 0) return false;
+    _rx_end += static_cast<size_t>(n);
+    return true;
+}
+bool SerialPort::readLine(LineView& line, int timeout_ms) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (;;) {
+        // 버퍼에 이미 완성된 줄이 있으면 바로 반환
+        const char* base = _rx.data();
+        const void* eol = std::memchr(base + _rx_scanned, '\n', _rx_end - _rx_scanned);
+        if (eol) {
+            size_t end = static_cast<const char*>(eol) - base;
+            size_t len = end - _rx_start;
+            if (len > 0 && base[end - 1] == '\r') --len;
+            line.data = base + _rx_start;
+            line.size = len;
+            _rx_start = _rx_scanned = end + 1;
+            if (_rx_start == _rx_end) _rx_start = _rx_end = _rx_scanned = 0;
+            return true;
+        }
+        _rx_scanned = _rx_end;
+
+        int remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+        // timeout_ms == 0: 이미 도착한 데이터만 확인 (poll 0)
+        if (remaining < 0 || !waitReadable(remaining)) return false;
+        if (!fillBuffer()) return false;
+    }
+}
+void SerialPort::flushInput() {
+    if (_fd >= 0) tcflush(_fd, TCIFLUSH);
+    _rx_start = _rx_end = _rx_scanned = 0;
+}
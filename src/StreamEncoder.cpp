@@ -0,0 +1,185 @@
+#include "StreamEncoder.hpp"
+#include "MatrixCache.hpp"
+#include "XxHash64.hpp"
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <iostream>
+#include <memory>
+
+namespace RaptorQ = RaptorQ__v1;
+
+StreamEncoder::StreamEncoder(uint16_t symbol_size, double overhead_ratio)
+    : _symbol_size(symbol_size), _overhead_ratio(overhead_ratio) {}
+
+bool StreamEncoder::readBlock(int fd, const SourceBlock& sb, std::vector<uint8_t>& buffer)
+{
+    // resize()는 capacity를 줄이지 않으므로 블록마다 재할당이 일어나지 않음
+    buffer.resize(sb.length);
+    size_t done = 0;
+    while (done < sb.length) {
+        ssize_t n = pread(fd, buffer.data() + done, sb.length - done, static_cast<off_t>(sb.offset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += static_cast<size_t>(n);
+    }
+    // 이미 읽은 구간은 page cache에 남길 필요 없음
+    posix_fadvise(fd, static_cast<off_t>(sb.offset), static_cast<off_t>(sb.length), POSIX_FADV_DONTNEED);
+    return true;
+}
+
+bool StreamEncoder::hashFile(const std::string& path, uint64_t& hash, uint64_t& length)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    XxHash64 hasher;
+    std::vector<uint8_t> buffer(1024 * 1024);
+    bool ok = true;
+    for (;;) {
+        ssize_t n = read(fd, buffer.data(), buffer.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) ok = false;
+        if (n <= 0) break;
+        hasher.update(buffer.data(), static_cast<size_t>(n));
+    }
+    close(fd);
+    hash = hasher.digest();
+    length = hasher.length();
+    return ok;
+}
+
+bool StreamEncoder::encodeBlock(const SourceBlock& sb, std::vector<uint8_t>& buffer, const PacketSink& sink)
+{
+    using InputIt = std::vector<uint8_t>::iterator;
+    using OutputIt = std::vector<uint8_t>::iterator;
+    using Encoder = RaptorQ::Encoder<InputIt, OutputIt>;
+
+    uint32_t num_source_symbols = static_cast<uint32_t>(sb.block);
+    uint32_t num_repair_symbols = repair_symbol_count(num_source_symbols, _overhead_ratio);
+    const size_t packet_size = PAYLOAD_ID_SIZE + _symbol_size;
+
+    std::vector<uint8_t> packet(packet_size);
+
+    // cache된 G: 블록 버퍼를 K * T로 늘려(0-padding) 그대로 source, repair = G * source
+    std::shared_ptr<const RepairMatrix> matrix = _matrix_cache ? _matrix_cache->get(sb.block, num_repair_symbols) : nullptr;
+    std::unique_ptr<Encoder> encoder;
+    if (matrix) {
+        buffer.resize(static_cast<size_t>(num_source_symbols) * _symbol_size, 0);
+    } else {
+        encoder.reset(new Encoder(sb.block, _symbol_size));
+        encoder->set_data(buffer.begin(), buffer.end());
+        if (!encoder->compute_sync()) {
+            std::cerr << "Encoder pre-computation failed (SBN " << static_cast<int>(sb.sbn) << ")" << std::endl;
+            return false;
+        }
+    }
+
+    // repair는 ESI 구간으로 나눠 여러 thread에서 arena의 제자리에 생성 (sink 순서는 그대로 ESI 순)
+    //  - resize()는 capacity를 줄이지 않으므로 블록마다 재할당 없음
+    _repair_arena.resize(static_cast<size_t>(num_repair_symbols) * packet_size);
+    parallel_for_ranges(num_repair_symbols, REPAIR_CHUNK_MIN_SYMBOLS, _num_threads, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            uint32_t esi = num_source_symbols + static_cast<uint32_t>(r);
+            auto repair_packet = _repair_arena.begin() + r * packet_size;
+            if (matrix) {
+                matrix->encodeRepair(static_cast<uint32_t>(r), buffer.data(), _symbol_size, &*repair_packet + PAYLOAD_ID_SIZE);
+            } else {
+                auto out_it = repair_packet + PAYLOAD_ID_SIZE;
+                encoder->encode(out_it, repair_packet + packet_size, esi);
+            }
+            write_payload_id(&*repair_packet, sb.sbn, esi);
+        }
+    });
+
+    for (uint32_t esi = 0; esi < num_source_symbols; ++esi) {
+        if (matrix) {
+            std::copy_n(buffer.data() + static_cast<size_t>(esi) * _symbol_size, _symbol_size, packet.data() + PAYLOAD_ID_SIZE);
+        } else {
+            auto out_it = packet.begin() + PAYLOAD_ID_SIZE;
+            encoder->encode(out_it, packet.end(), esi);
+        }
+        write_payload_id(packet.data(), sb.sbn, esi);
+
+        if (!sink(packet.data(), packet.size())) return false;
+        ++_packets;
+    }
+    for (uint32_t r = 0; r < num_repair_symbols; ++r) {
+        if (!sink(_repair_arena.data() + static_cast<size_t>(r) * packet_size, packet_size)) return false;
+        ++_packets;
+    }
+    return true;
+}
+
+std::vector<SourceBlock> StreamEncoder::partition(uint64_t transfer_length, uint16_t symbol_size, size_t max_block_bytes)
+{
+    // 블록 크기 상한이 있으면 그만큼 블록 수를 늘림
+    //  - 상한은 soft cap: 블록 수는 MAX_SOURCE_BLOCKS까지만, 그 이상이면 블록이 K_max * T까지 커짐
+    //    (실패는 maxTransferLength()를 넘는 파일뿐)
+    uint64_t min_blocks = 1;
+    if (symbol_size > 0 && max_block_bytes >= symbol_size) {
+        uint64_t max_symbols = max_block_bytes / symbol_size;
+        uint64_t total_symbols = (transfer_length + symbol_size - 1) / symbol_size;
+        min_blocks = std::max<uint64_t>(1, (total_symbols + max_symbols - 1) / max_symbols);
+    }
+    min_blocks = std::min<uint64_t>(min_blocks, MAX_SOURCE_BLOCKS);
+    if (transfer_length > maxTransferLength(symbol_size)) return std::vector<SourceBlock>();
+    return partition_source_blocks(static_cast<size_t>(transfer_length), symbol_size, static_cast<uint32_t>(min_blocks));
+}
+
+uint64_t StreamEncoder::maxTransferLength(uint16_t symbol_size)
+{
+    return static_cast<uint64_t>(MAX_SOURCE_BLOCKS) * max_block_symbols() * symbol_size;
+}
+
+bool StreamEncoder::encodeFile(const std::string& path, size_t max_block_bytes, const PacketSink& sink)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open File " << path << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    _transfer_length = static_cast<uint64_t>(st.st_size);
+    _packets = 0;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    _blocks = partition(_transfer_length, _symbol_size, max_block_bytes);
+    if (_blocks.empty()) {
+        std::cerr << "Error: File too large (limit " << maxTransferLength(_symbol_size) << " bytes = " << MAX_SOURCE_BLOCKS
+                  << " source blocks of " << max_block_symbols() << " symbols)" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    std::vector<uint8_t> current;
+    std::vector<uint8_t> next;
+    bool ok = readBlock(fd, _blocks[0], current);
+
+    for (size_t i = 0; ok && i < _blocks.size(); ++i) {
+        // 다음 블록 읽기를 인코딩과 겹쳐서 실행
+        std::future<bool> prefetch;
+        if (i + 1 < _blocks.size()) {
+            prefetch = std::async(std::launch::async, &StreamEncoder::readBlock, this,
+                                  fd, std::cref(_blocks[i + 1]), std::ref(next));
+        }
+
+        ok = encodeBlock(_blocks[i], current, sink);
+
+        if (prefetch.valid()) ok = prefetch.get() && ok;
+        current.swap(next);
+    }
+
+    close(fd);
+    return ok;
+}
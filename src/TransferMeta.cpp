@@ -0,0 +1,106 @@
+#include "TransferMeta.hpp"
+#include "Base64Simd.hpp"
+#include "Crc32c.hpp"
+#include "XxHash64.hpp"
+#include <fstream>
+#include <vector>
+
+static const uint8_t META_FLAG_HASH = 0x01;
+
+static void put_be(uint8_t* p, uint64_t v, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) p[i] = static_cast<uint8_t>(v >> (8 * (n - 1 - i)));
+}
+
+static uint64_t get_be(const uint8_t* p, size_t n)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+TransferMeta make_transfer_meta(uint64_t transfer_length, uint16_t symbol_size, uint16_t num_blocks,
+                                uint16_t num_source_symbols, bool has_hash, uint64_t content_hash)
+{
+    TransferMeta meta;
+    meta.transfer_length = transfer_length;
+    meta.symbol_size = symbol_size;
+    meta.num_blocks = num_blocks;
+    meta.num_source_symbols = num_source_symbols;
+    meta.has_oti = true;
+    meta.has_hash = has_hash;
+    meta.content_hash = has_hash ? content_hash : 0;
+
+    // transfer ID = xxh64(record의 OTI + hash 부분)의 하위 32 bit
+    //  - 같은 파일을 같은 설정으로 다시 보내면 같은 ID (수신 측이 이전 심볼과 합칠 수 있음)
+    uint8_t record[META_RECORD_SIZE];
+    encode_transfer_meta(meta, record);
+    meta.transfer_id = static_cast<uint32_t>(xxh64(record + 2, 12) ^ meta.content_hash);
+    return meta;
+}
+
+size_t encode_transfer_meta(const TransferMeta& meta, uint8_t* out)
+{
+    out[0] = META_MAGIC;
+    out[1] = META_VERSION;
+    out[2] = meta.has_hash ? META_FLAG_HASH : 0;
+    put_be(out + 3, meta.transfer_length, 5);
+    put_be(out + 8, meta.symbol_size, 2);
+    put_be(out + 10, meta.num_blocks, 2);
+    put_be(out + 12, meta.num_source_symbols, 2);
+    put_be(out + 14, meta.transfer_id, 4);
+    put_be(out + 18, meta.content_hash, 8);
+    put_be(out + 26, crc32c(out, 26), 4);
+    return META_RECORD_SIZE;
+}
+
+bool parse_transfer_meta(const uint8_t* data, size_t len, TransferMeta& out)
+{
+    if (len < 2 || data[0] != META_MAGIC) return false;
+
+    if (len == META_V1_RECORD_SIZE && data[1] == 1) {
+        if (crc32c(data, 18) != static_cast<uint32_t>(get_be(data + 18, 4))) return false;
+        out = TransferMeta();
+        out.transfer_length = get_be(data + 2, 8);
+        out.has_hash = true;
+        out.content_hash = get_be(data + 10, 8);
+        return true;
+    }
+
+    if (len != META_RECORD_SIZE || data[1] != META_VERSION) return false;
+    if (crc32c(data, 26) != static_cast<uint32_t>(get_be(data + 26, 4))) return false;
+    out = TransferMeta();
+    out.has_hash = (data[2] & META_FLAG_HASH) != 0;
+    out.transfer_length = get_be(data + 3, 5);
+    out.symbol_size = static_cast<uint16_t>(get_be(data + 8, 2));
+    out.num_blocks = static_cast<uint16_t>(get_be(data + 10, 2));
+    out.num_source_symbols = static_cast<uint16_t>(get_be(data + 12, 2));
+    out.transfer_id = static_cast<uint32_t>(get_be(data + 14, 4));
+    out.content_hash = get_be(data + 18, 8);
+    // T = 0 / Z = 0 인 record로는 Decoder를 만들 수 없음
+    out.has_oti = out.symbol_size > 0 && out.num_blocks > 0;
+    return true;
+}
+
+bool scan_transfer_meta(const std::string& path, TransferMeta& out)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    std::vector<uint8_t> record(META_RECORD_SIZE);
+    bool found = false;
+    while (std::getline(in, line)) {
+        // 길이가 맞는 줄만 디코딩 (데이터 줄은 대부분 여기서 걸러짐)
+        if (base64_decoded_max_size(line.size()) > META_RECORD_SIZE + 2) continue;
+        size_t len = 0;
+        TransferMeta meta;
+        if (base64_decode_to(line.data(), line.size(), record.data(), record.size(), len) != Base64Status::OK ||
+            !parse_transfer_meta(record.data(), len, meta)) {
+            continue;
+        }
+        if (!found || meta.has_oti) out = meta;
+        found = true;
+        if (meta.has_oti) break;
+    }
+    return found;
+}
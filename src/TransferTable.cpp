@@ -0,0 +1,338 @@
+#include "TransferTable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+static int64_t now_ms()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 한 전송의 메모리 추정치: 출력 버퍼(F) + 블록별 Decoder가 보관하는 심볼 (K * T)
+static uint64_t estimate_footprint(const TransferMeta& meta)
+{
+    return meta.transfer_length + static_cast<uint64_t>(meta.num_blocks) * meta.num_source_symbols * meta.symbol_size;
+}
+
+TransferTable::TransferTable(const Options& options, EventSink sink)
+    : _opt(options), _sink(std::move(sink)), _pool(new ThreadPool(options.workers)) {}
+
+TransferTable::Event TransferTable::makeEvent(EventType type, const Transfer& t, const char* reason) const
+{
+    Event e;
+    e.type = type;
+    e.address = t.key.first;
+    e.transfer_id = t.key.second;
+    e.transfer_length = t.meta.transfer_length;
+    e.path = t.path;
+    e.reason = reason;
+    e.elapsed_s = (now_ms() - t.started_ms) / 1000.0;
+    if (t.fec) {
+        e.hash_verified = t.fec->hashStatus() == FecDecoder::HashStatus::MATCH;
+        e.valid_bytes = t.fec->validBytes();
+        e.ranges = format_ranges(t.fec->validRanges());
+        e.symbols_arrived = t.fec->symbolsArrived();
+        e.symbols_expected = t.fec->symbolsExpected();
+    }
+    return e;
+}
+
+// ==========================================================
+// Packet routing (decoder thread)
+// ==========================================================
+void TransferTable::addPacket(const uint8_t* packet, size_t len, int address)
+{
+    poll();
+
+    TransferMeta meta;
+    if (parse_transfer_meta(packet, len, meta) && meta.has_oti) {
+        onMeta(meta, address);
+        return;
+    }
+
+    AddressState& as = _addresses[address];
+    if (!as.current) {
+        // 처음 보는 주소: OTI record를 기다림 / 끝난 전송 뒤: 버림
+        if (as.finished) {
+            _stats.packets_dropped++;
+            onLatePacket(as.finished_key);
+        } else if (as.waiting.size() >= _opt.max_waiting_packets) {
+            _stats.packets_dropped++;
+        } else {
+            as.waiting.emplace_back(packet, packet + len);
+        }
+        return;
+    }
+    route(*as.current, packet, len);
+}
+
+void TransferTable::onMeta(const TransferMeta& meta, int address)
+{
+    Key key(address, meta.transfer_id);
+    AddressState& as = _addresses[address];
+
+    // 이미 끝났거나 거부한 전송의 반복 record (마지막 record, 다시 보낸 전송)
+    //  - 제거(EVICTED)한 전송은 backoff가 지난 뒤에만 처음부터 다시 받음
+    auto it = _transfers.find(key);
+    auto f = _finished.find(key);
+    bool blocked = it == _transfers.end() && f != _finished.end() &&
+                   !(f->second.outcome == EventType::EVICTED && now_ms() >= f->second.retry_after_ms);
+    Transfer* t = nullptr;
+    if (!blocked) t = it != _transfers.end() ? it->second.get() : startTransfer(meta, address);
+    if (!t) {
+        as.current = nullptr;
+        as.finished = true;
+        as.finished_key = key;
+        as.waiting.clear();
+        if (blocked) onLatePacket(key);
+        return;
+    }
+    as.current = t;
+    as.finished = false;
+
+    // OTI 전에 도착한 패킷 (같은 주소의 이 전송으로 간주)
+    while (!as.waiting.empty() && as.current == t) {
+        std::vector<uint8_t> p = std::move(as.waiting.front());
+        as.waiting.pop_front();
+        _stats.packets_replayed++;
+        route(*t, p.data(), p.size());
+    }
+    as.waiting.clear();
+}
+
+TransferTable::Transfer* TransferTable::startTransfer(const TransferMeta& meta, int address)
+{
+    Key key(address, meta.transfer_id);
+    std::unique_ptr<Transfer> t(new Transfer);
+    t->key = key;
+    t->meta = meta;
+    t->started_ms = t->last_update_ms = now_ms();
+    std::ostringstream name;
+    name << _opt.output_dir << "/" << address << "_" << std::hex << std::setw(8) << std::setfill('0') << meta.transfer_id << ".bin";
+    t->path = name.str();
+    t->footprint = estimate_footprint(meta);
+
+    // 한 전송이 상한보다 크면 받지 않음, 아니면 LRU로 자리를 만듦
+    const char* reject = nullptr;
+    if (t->footprint > _opt.memory_budget) reject = "larger than the memory budget";
+    else if (!makeRoom(t->footprint)) reject = "memory budget is held by transfers being decoded";
+    if (!reject) {
+        t->fec.reset(new FecDecoder(meta));
+        if (!t->fec->valid()) reject = "invalid transfer parameters";
+        else if (!t->file.open(t->path, meta.transfer_length)) reject = "cannot open output file";
+    }
+    if (reject) {
+        t->fec.reset();
+        _stats.rejected++;
+        Finished& f = _finished[key];
+        f.outcome = EventType::REJECTED;
+        f.at_ms = now_ms();
+        if (_sink) _sink(makeEvent(EventType::REJECTED, *t, reject));
+        return nullptr;
+    }
+
+    Transfer* raw = t.get();
+    raw->fec->setOutputSink([raw](uint64_t offset, const uint8_t* data, size_t len) {
+        raw->file.write(offset, data, len);
+    });
+    _transfers[key] = std::move(t);
+    _stats.started++;
+    _stats.memory_in_use += raw->footprint;
+    _stats.memory_high_water = std::max(_stats.memory_high_water, _stats.memory_in_use);
+    if (_sink) _sink(makeEvent(EventType::STARTED, *raw));
+    return raw;
+}
+
+void TransferTable::route(Transfer& t, const uint8_t* packet, size_t len)
+{
+    // worker가 디코딩 중 (이미 ready -> 더 필요 없음)
+    if (t.state == State::DECODING) {
+        _stats.packets_dropped++;
+        return;
+    }
+    t.last_update_ms = now_ms();
+    _stats.packets_routed++;
+    FecDecoder::AddResult r = t.fec->addPacket(packet, len);
+    if (r == FecDecoder::AddResult::ADDED && t.fec->ready()) submitDecode(t);
+}
+
+// ==========================================================
+// Decode (worker thread) / completion (decoder thread)
+// ==========================================================
+void TransferTable::submitDecode(Transfer& t)
+{
+    Completion c;
+    c.key = t.key;
+    // source symbol만으로 끝난 블록뿐이면 행렬 디코딩이 없음 -> 바로 완료
+    if (t.fec->decoded()) {
+        c.ok = true;
+        c.hash = t.fec->hashStatus();
+        if (c.hash == FecDecoder::HashStatus::MISMATCH) c.reopened = t.fec->reopenBlocks();
+        finishDecode(c);
+        return;
+    }
+
+    // 이후 이 전송의 fec / file은 worker가 소유 (decoder thread는 DECODING이면 건드리지 않음)
+    t.state = State::DECODING;
+    _stats.decoding++;
+    Transfer* raw = &t;
+    _pool->submit([this, raw, c]() mutable {
+        c.ok = raw->fec->decode();
+        c.rank_deficient = !c.ok && !raw->fec->ready();
+        c.hash = raw->fec->hashStatus();
+        if (c.ok && c.hash == FecDecoder::HashStatus::MISMATCH) c.reopened = raw->fec->reopenBlocks();
+        std::lock_guard<std::mutex> lock(_completion_mutex);
+        _completions.push_back(c);
+    });
+}
+
+void TransferTable::finishDecode(const Completion& c)
+{
+    auto it = _transfers.find(c.key);
+    if (it == _transfers.end()) return;
+    Transfer& t = *it->second;
+    if (t.state == State::DECODING) _stats.decoding--;
+    t.state = State::RECEIVING;
+
+    if (c.ok && c.hash == FecDecoder::HashStatus::MISMATCH) {
+        // 다시 연 블록은 같은 주소의 다음 심볼로 계속 받음
+        t.last_update_ms = now_ms();
+        if (_sink) _sink(makeEvent(EventType::REOPENED, t, "content hash mismatch"));
+        return;
+    }
+    if (c.rank_deficient) {
+        // rank가 부족한 블록은 받은 심볼을 유지한 채 다시 열림 -> 몇 개만 더 받으면 됨
+        t.last_update_ms = now_ms();
+        if (_sink) _sink(makeEvent(EventType::REOPENED, t, "rank deficient block"));
+        return;
+    }
+
+    EventType type = c.ok ? EventType::COMPLETED : EventType::FAILED;
+    if (c.ok) _stats.completed++;
+    else _stats.failed++;
+    t.file.close();
+    Event event = makeEvent(type, t, c.ok ? "" : "decode failed");
+    if (_sink) _sink(event);
+
+    Finished& f = _finished[c.key];
+    f.outcome = type;
+    f.at_ms = f.last_late_ms = now_ms();
+    f.completed = event;
+    removeTransfer(c.key);
+}
+
+void TransferTable::poll()
+{
+    std::vector<Completion> done;
+    {
+        std::lock_guard<std::mutex> lock(_completion_mutex);
+        done.swap(_completions);
+    }
+    for (const auto& c : done) finishDecode(c);
+
+    // stale: 오래 갱신되지 않은 미완료 전송 / 끝난 전송 기록 (1초에 한 번만 확인)
+    int64_t now = now_ms();
+    if (now - _last_sweep_ms < 1000) return;
+    _last_sweep_ms = now;
+    std::vector<Key> stale;
+    for (const auto& kv : _transfers) {
+        const Transfer& t = *kv.second;
+        if (t.state == State::RECEIVING && now - t.last_update_ms > _opt.stale_ms) stale.push_back(kv.first);
+    }
+    for (const auto& key : stale) evictTransfer(key, "stale");
+    for (auto it = _finished.begin(); it != _finished.end();) {
+        if (now - it->second.at_ms > _opt.stale_ms && now >= it->second.retry_after_ms) it = _finished.erase(it);
+        else ++it;
+    }
+}
+
+void TransferTable::drain()
+{
+    while (_stats.decoding > 0) {
+        poll();
+        if (_stats.decoding > 0) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+// ==========================================================
+// Memory budget (LRU)
+// ==========================================================
+bool TransferTable::makeRoom(uint64_t bytes)
+{
+    while (_stats.memory_in_use + bytes > _opt.memory_budget) {
+        // 디코딩 중인 전송은 worker가 쓰고 있으므로 제외
+        Transfer* oldest = nullptr;
+        for (const auto& kv : _transfers) {
+            Transfer* t = kv.second.get();
+            if (t->state == State::RECEIVING && (!oldest || t->last_update_ms < oldest->last_update_ms)) oldest = t;
+        }
+        if (!oldest) return false;
+        evictTransfer(oldest->key, "memory budget (least recently updated)");
+    }
+    return true;
+}
+
+void TransferTable::evictTransfer(const Key& key, const char* reason)
+{
+    auto it = _transfers.find(key);
+    if (it == _transfers.end()) return;
+    _stats.evicted++;
+    if (_sink) _sink(makeEvent(EventType::EVICTED, *it->second, reason));
+
+    // 반복되는 OTI record(16 패킷마다)로 바로 다시 시작하면 같은 전송이 다른 전송을 다시 밀어냄
+    int64_t now = now_ms();
+    Finished& f = _finished[key];
+    f.outcome = EventType::EVICTED;
+    f.at_ms = now;
+    f.evictions++;
+    int64_t backoff = static_cast<int64_t>(_opt.evict_backoff_ms) << std::min<uint32_t>(f.evictions - 1, 16);
+    f.retry_after_ms = now + std::min<int64_t>(backoff, _opt.stale_ms);
+    removeTransfer(key);
+}
+
+void TransferTable::onLatePacket(const Key& key)
+{
+    auto it = _finished.find(key);
+    if (it == _finished.end() || it->second.outcome != EventType::COMPLETED) return;
+    int64_t now = now_ms();
+    if (now - it->second.last_late_ms < _opt.done_resend_ms) return;
+    it->second.last_late_ms = now;
+    if (_sink) {
+        Event e = it->second.completed;
+        e.type = EventType::LATE_PACKETS;
+        _sink(e);
+    }
+}
+
+void TransferTable::removeTransfer(const Key& key)
+{
+    auto it = _transfers.find(key);
+    if (it == _transfers.end()) return;
+    // 이 주소에서 이어서 오는 패킷은 이 전송의 것 -> 다음 OTI record까지 버림
+    AddressState& as = _addresses[key.first];
+    if (as.current == it->second.get()) {
+        as.current = nullptr;
+        as.finished = true;
+        as.finished_key = key;
+    }
+    _stats.memory_in_use -= it->second->footprint;
+    _transfers.erase(it);
+}
+
+void TransferTable::forEachReceiving(const std::function<void(int address, const FecDecoder& fec)>& fn) const
+{
+    for (const auto& kv : _addresses) {
+        const Transfer* t = kv.second.current;
+        if (t && t->state == State::RECEIVING && !t->fec->ready()) fn(kv.first, *t->fec);
+    }
+}
+
+TransferTable::Stats TransferTable::stats() const
+{
+    Stats s = _stats;
+    s.active = _transfers.size();
+    return s;
+}
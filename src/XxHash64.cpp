@@ -0,0 +1,122 @@
+#include "XxHash64.hpp"
+#include <cstring>
+
+static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// 입력은 little-endian으로 읽음 (xxHash 정의)
+static inline uint64_t read64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+static inline uint32_t read32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME2;
+    acc = rotl(acc, 31);
+    return acc * PRIME1;
+}
+
+static inline uint64_t merge_round(uint64_t acc, uint64_t val)
+{
+    acc ^= xxh_round(0, val);
+    return acc * PRIME1 + PRIME4;
+}
+
+XxHash64::XxHash64(uint64_t seed) : _seed(seed)
+{
+    _v[0] = seed + PRIME1 + PRIME2;
+    _v[1] = seed + PRIME2;
+    _v[2] = seed;
+    _v[3] = seed - PRIME1;
+}
+
+void XxHash64::update(const uint8_t* data, size_t len)
+{
+    _total += len;
+
+    // 이전 호출에서 남은 32 bytes 미만을 먼저 채움
+    if (_buf_len + len < 32) {
+        std::memcpy(_buf + _buf_len, data, len);
+        _buf_len += len;
+        return;
+    }
+    if (_buf_len > 0) {
+        size_t fill = 32 - _buf_len;
+        std::memcpy(_buf + _buf_len, data, fill);
+        for (int i = 0; i < 4; ++i) _v[i] = xxh_round(_v[i], read64(_buf + 8 * i));
+        data += fill;
+        len -= fill;
+        _buf_len = 0;
+    }
+
+    // 32 bytes stripe 단위
+    while (len >= 32) {
+        for (int i = 0; i < 4; ++i) _v[i] = xxh_round(_v[i], read64(data + 8 * i));
+        data += 32;
+        len -= 32;
+    }
+    std::memcpy(_buf, data, len);
+    _buf_len = len;
+}
+
+uint64_t XxHash64::digest() const
+{
+    uint64_t h;
+    if (_total >= 32) {
+        h = rotl(_v[0], 1) + rotl(_v[1], 7) + rotl(_v[2], 12) + rotl(_v[3], 18);
+        for (int i = 0; i < 4; ++i) h = merge_round(h, _v[i]);
+    } else {
+        h = _seed + PRIME5;
+    }
+    h += _total;
+
+    const uint8_t* p = _buf;
+    size_t len = _buf_len;
+    while (len >= 8) {
+        h ^= xxh_round(0, read64(p));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+        p += 8;
+        len -= 8;
+    }
+    if (len >= 4) {
+        h ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        p += 4;
+        len -= 4;
+    }
+    while (len > 0) {
+        h ^= (*p) * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+        ++p;
+        --len;
+    }
+
+    // avalanche
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t xxh64(const uint8_t* data, size_t len, uint64_t seed)
+{
+    XxHash64 state(seed);
+    state.update(data, len);
+    return state.digest();
+}
@@ -0,0 +1,246 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iterator>
+#include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Base64Simd.hpp"
+#include "CodecProtocol.hpp"
+#include "FecBlocks.hpp"
+#include "TransferMeta.hpp"
+
+// --- FEC Codec Client (fec_daemon에 encode / decode job 전달) ---
+//  - encode: 결과를 FEC_base64와 같은 Base64 텍스트로 저장 (metadata record 처음 / 16줄마다 / 끝)
+//  - decode: Base64 텍스트의 OTI record + 패킷을 daemon으로 보내고 복원 결과 저장
+//  - --repeat N: 같은 연결로 job을 N번 (첫 job = cold, 나머지 = RaptorQ cache가 warm인 경우)
+
+using Clock = std::chrono::steady_clock;
+
+static int connect_daemon(const std::string& path)
+{
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static std::string error_text(const std::vector<uint8_t>& body)
+{
+    return std::string(body.begin(), body.end());
+}
+
+// ==========================================================
+// Encode: ENCODE -> META + PACKET * n + END
+// ==========================================================
+static int run_encode(int fd, const std::string& input, const std::string& output, const EncodeParams& params, int repeat)
+{
+    std::ifstream file(input, std::ios::binary);
+    if (!file) {
+        std::cerr << "[ERROR] Cannot open File " << input << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> request(CODEC_ENCODE_PARAMS_SIZE);
+    encode_params(params, request.data());
+    request.insert(request.end(), std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (request.size() > CODEC_MAX_MESSAGE) {
+        std::cerr << "[ERROR] Input larger than " << (CODEC_MAX_MESSAGE >> 20) << " MiB" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> lines;     // 첫 job의 결과 (Base64 한 줄씩)
+    std::vector<char> line_buf;
+    std::vector<double> job_ms;
+    CodecWriter out(fd);
+    for (int job = 0; job < repeat; ++job) {
+        Clock::time_point start = Clock::now();
+        if (!out.send(CodecMsg::ENCODE, request.data(), request.size()) || !out.flush()) {
+            std::cerr << "[ERROR] Connection to daemon lost" << std::endl;
+            return 1;
+        }
+
+        CodecMsg type;
+        std::vector<uint8_t> body;
+        for (;;) {
+            if (!read_codec_message(fd, type, body)) {
+                std::cerr << "[ERROR] Connection to daemon lost" << std::endl;
+                return 1;
+            }
+            if (type == CodecMsg::ERROR) {
+                std::cerr << "[FAILURE] " << error_text(body) << std::endl;
+                return 1;
+            }
+            if (type == CodecMsg::END) break;
+            if (job > 0) continue;
+            line_buf.resize(std::max(line_buf.size(), base64_encoded_size(body.size())));
+            size_t line_len = 0;
+            base64_encode_to(body.data(), body.size(), line_buf.data(), line_buf.size(), line_len);
+            lines.emplace_back(line_buf.data(), line_len);
+        }
+        job_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    // META는 첫 줄 -> 데이터 줄 META_REPEAT_INTERVAL개마다, 끝에 다시
+    std::ofstream output_file(output);
+    if (!output_file || lines.empty()) {
+        std::cerr << "[ERROR] Cannot open file " << output << std::endl;
+        return 1;
+    }
+    const std::string& meta_line = lines[0];
+    output_file << meta_line << "\n";
+    size_t data_lines = lines.size() - 1;
+    for (size_t i = 1; i < lines.size(); ++i) {
+        output_file << lines[i] << "\n";
+        if (i % META_REPEAT_INTERVAL == 0) output_file << meta_line << "\n";
+    }
+    if (data_lines % META_REPEAT_INTERVAL != 0) output_file << meta_line << "\n";
+    if (!output_file) {
+        std::cerr << "[ERROR] Cannot write file " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Saved " << data_lines << " packets to " << output << std::endl;
+    std::cout << "  First job: " << job_ms[0] << " ms";
+    if (job_ms.size() > 1) {
+        double warm = 0.0;
+        for (size_t i = 1; i < job_ms.size(); ++i) warm += job_ms[i];
+        std::cout << ", warm jobs: " << warm / (job_ms.size() - 1) << " ms mean (" << job_ms.size() - 1 << " jobs)";
+    }
+    std::cout << std::endl;
+    return 0;
+}
+
+// ==========================================================
+// Decode: DECODE(OTI) + PACKET * n + END -> DATA + END
+// ==========================================================
+static int run_decode(int fd, const std::string& input, const std::string& output, bool framed)
+{
+    TransferMeta meta;
+    if (!scan_transfer_meta(input, meta) || !meta.has_oti) {
+        std::cerr << "[ERROR] No OTI metadata record in " << input << std::endl;
+        return 1;
+    }
+    std::ifstream file(input);
+    if (!file) {
+        std::cerr << "[ERROR] Cannot open File " << input << std::endl;
+        return 1;
+    }
+
+    Clock::time_point start = Clock::now();
+    CodecWriter out(fd);
+    uint8_t request[1 + META_RECORD_SIZE];
+    request[0] = framed ? CODEC_FLAG_FRAMED : 0;
+    encode_transfer_meta(meta, request + 1);
+    bool ok = out.send(CodecMsg::DECODE, request, sizeof(request));
+
+    // 깨진 줄은 버림 (손실과 같음), metadata record는 이미 보냄
+    std::string line;
+    std::vector<uint8_t> packet;
+    uint32_t sent = 0;
+    while (ok && std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        packet.resize(base64_decoded_max_size(line.size()));
+        size_t len = 0;
+        TransferMeta ignored;
+        if (base64_decode_to(line.data(), line.size(), packet.data(), packet.size(), len) != Base64Status::OK ||
+            parse_transfer_meta(packet.data(), len, ignored)) {
+            continue;
+        }
+        ok = out.send(CodecMsg::PACKET, packet.data(), len);
+        sent++;
+    }
+    ok = ok && out.send(CodecMsg::END, nullptr, 0) && out.flush();
+
+    CodecMsg type;
+    std::vector<uint8_t> body, data;
+    while (ok) {
+        ok = read_codec_message(fd, type, body);
+        if (!ok) break;
+        if (type == CodecMsg::ERROR) {
+            std::cerr << "[FAILURE] " << error_text(body) << std::endl;
+            return 1;
+        }
+        if (type == CodecMsg::DATA) data.swap(body);
+        if (type == CodecMsg::END) break;
+    }
+    if (!ok) {
+        std::cerr << "[ERROR] Connection to daemon lost" << std::endl;
+        return 1;
+    }
+    bool verified = !body.empty() && body[0] == CODEC_HASH_VERIFIED;
+
+    std::ofstream output_file(output, std::ios::binary);
+    output_file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!output_file) {
+        std::cerr << "[ERROR] Cannot write file " << output << std::endl;
+        return 1;
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cout << "[SUCCESS] " << data.size() << " bytes from " << sent << " packets -> " << output
+              << (verified ? " (content hash verified)" : " (no content hash)") << ", " << ms << " ms" << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    // ==========================================================
+    // A: Options
+    // ==========================================================
+    if (argc < 4 || (std::string(argv[1]) != "encode" && std::string(argv[1]) != "decode")) {
+        std::cout << "[Error] Usage: ./fec_client encode <input> <output.txt> [--socket PATH] [--symbol-size N] [--overhead P]" << std::endl;
+        std::cout << "                          [--blocks N] [--id full|compact] [--check none|crc32c] [--repeat N]" << std::endl;
+        std::cout << "       ./fec_client decode <input.txt> <output> [--socket PATH] [--framed]" << std::endl;
+        std::cout << "  Example: ./fec_client encode ../data/sample_data.txt ../data/encoded_correct.txt --repeat 100" << std::endl;
+        return 1;
+    }
+    const bool encode = std::string(argv[1]) == "encode";
+    std::string socket_path = DEFAULT_CODEC_SOCKET;
+    EncodeParams params;
+    int repeat = 1;
+    bool framed = false;
+
+    for (int i = 4; i < argc; ++i) {
+        std::string opt = argv[i];
+        bool has_value = i + 1 < argc;
+        if (opt == "--socket" && has_value) socket_path = argv[++i];
+        else if (opt == "--symbol-size" && has_value) params.symbol_size = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else if (opt == "--overhead" && has_value) params.overhead_ratio = std::stod(argv[++i]);
+        else if (opt == "--blocks" && has_value) params.min_blocks = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else if (opt == "--repeat" && has_value) repeat = std::max(1, std::stoi(argv[++i]));
+        else if (opt == "--id" && has_value && (std::string(argv[i + 1]) == "full" || std::string(argv[i + 1]) == "compact")) {
+            if (std::string(argv[++i]) == "compact") params.flags |= CODEC_FLAG_COMPACT_ID;
+        }
+        else if (opt == "--check" && has_value && (std::string(argv[i + 1]) == "none" || std::string(argv[i + 1]) == "crc32c")) {
+            if (std::string(argv[++i]) == "crc32c") params.flags |= CODEC_FLAG_CRC32C;
+        }
+        else if (opt == "--framed") framed = true;
+        else {
+            std::cerr << "[ERROR] Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // ==========================================================
+    // B: Connect & Run Job
+    // ==========================================================
+    int fd = connect_daemon(socket_path);
+    if (fd < 0) {
+        std::cerr << "[ERROR] Cannot connect to fec_daemon at " << socket_path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    int rc = encode ? run_encode(fd, argv[2], argv[3], params, repeat) : run_decode(fd, argv[2], argv[3], framed);
+    close(fd);
+    return rc;
+}
@@ -0,0 +1,284 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <mutex>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <RaptorQ/RaptorQ_v1_hdr.hpp>       // RaptorQ Library
+
+#include "CodecProtocol.hpp"
+#include "FecBlocks.hpp"
+#include "FecDecoder.hpp"
+#include "RatelessEncoder.hpp"
+#include "ThreadPool.hpp"
+#include "TransferMeta.hpp"
+#include "XxHash64.hpp"
+
+// --- FEC Codec Daemon (Unix domain socket으로 encode / decode job을 받는 상주 프로세스) ---
+//  - 도구마다 프로세스를 새로 띄우면 job마다 실행 / 라이브러리 초기화 / compute_sync 행렬 계산을 반복
+//  - 상주 프로세스 하나가 RaptorQ의 precomputation cache(local_cache_size)를 유지
+//    -> 같은 (K, T) 조합의 두 번째 job부터는 행렬 분해를 다시 하지 않음
+//  - 연결마다 ThreadPool worker 하나, 한 연결에서 job을 여러 번 처리 (프로토콜: CodecProtocol.hpp)
+//  - 인코딩 결과는 블록 단위로 flush -> 클라이언트는 마지막 블록을 기다리지 않고 받기 시작
+
+using Clock = std::chrono::steady_clock;
+
+static volatile std::sig_atomic_t g_stop = 0;
+static void on_signal(int) { g_stop = 1; }
+
+// 전체 / (K, T)별 job 통계 (여러 worker가 갱신)
+struct DaemonStats {
+    std::mutex mutex;
+    uint64_t encode_jobs = 0, decode_jobs = 0, failed_jobs = 0;
+    uint64_t packets_out = 0, bytes_in = 0;
+    double busy_ms = 0.0;
+    std::map<std::pair<uint32_t, uint16_t>, uint64_t> shapes;   // (K, T) -> 블록 수 (cache를 다시 쓴 횟수)
+
+    void record(bool encode, bool ok, uint64_t packets, uint64_t bytes, double ms, const std::vector<SourceBlock>& blocks, uint16_t T)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        (encode ? encode_jobs : decode_jobs)++;
+        if (!ok) failed_jobs++;
+        packets_out += packets;
+        bytes_in += bytes;
+        busy_ms += ms;
+        for (const auto& sb : blocks) shapes[std::make_pair(static_cast<uint32_t>(sb.block), T)]++;
+    }
+};
+
+static double ms_since(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// ==========================================================
+// ENCODE: 원본 -> META + PACKET * n + END
+// ==========================================================
+static bool handle_encode(CodecWriter& out, const std::vector<uint8_t>& body, DaemonStats& stats)
+{
+    Clock::time_point start = Clock::now();
+    if (body.size() <= CODEC_ENCODE_PARAMS_SIZE) return out.send(CodecMsg::ERROR, "ENCODE: empty input") && out.flush();
+    EncodeParams params = parse_encode_params(body.data());
+    if (params.symbol_size == 0 || params.min_blocks == 0) return out.send(CodecMsg::ERROR, "ENCODE: invalid symbol size / blocks") && out.flush();
+
+    std::vector<uint8_t> data(body.begin() + CODEC_ENCODE_PARAMS_SIZE, body.end());
+    const uint64_t transfer_length = data.size();
+    const uint64_t content_hash = xxh64(data.data(), data.size());
+
+    // 블록마다 compute_sync (행렬은 RaptorQ cache에서, 두 번째 job부터는 계산 없음)
+    RatelessEncoder encoder(std::move(data), params.symbol_size, params.min_blocks);
+    if (!encoder.valid()) {
+        stats.record(true, false, 0, transfer_length, ms_since(start), encoder.blocks(), params.symbol_size);
+        return out.send(CodecMsg::ERROR, "ENCODE: cannot partition input / compute_sync failed") && out.flush();
+    }
+    const std::vector<SourceBlock>& blocks = encoder.blocks();
+
+    TransferMeta meta = make_transfer_meta(transfer_length, params.symbol_size, static_cast<uint16_t>(blocks.size()),
+                                           static_cast<uint16_t>(blocks[0].block), true, content_hash);
+    uint8_t record[META_RECORD_SIZE];
+    encode_transfer_meta(meta, record);
+    if (!out.send(CodecMsg::META, record, META_RECORD_SIZE)) return false;
+
+    PacketFormat format;
+    format.compact_id = (params.flags & CODEC_FLAG_COMPACT_ID) != 0;
+    format.crc = (params.flags & CODEC_FLAG_CRC32C) != 0;
+    format.sbn_bits = sbn_bits_for(blocks.size());
+
+    std::vector<uint8_t> packet(encoder.packetSize());
+    std::vector<uint8_t> formatted(packet_buffer_size(params.symbol_size));
+    uint32_t count = 0;
+    for (const auto& sb : blocks) {
+        uint32_t k = static_cast<uint32_t>(sb.block);
+        uint32_t repair = repair_symbol_count(k, params.overhead_ratio);
+        for (uint32_t i = 0; i < k + repair; ++i) {
+            if (i < k) encoder.sourcePacket(sb.sbn, i, packet.data());
+            else if (!encoder.nextRepairPacket(sb.sbn, packet.data())) break;
+            size_t len = format_packet(packet.data(), params.symbol_size, format, formatted.data());
+            if (!out.send(CodecMsg::PACKET, formatted.data(), len)) return false;
+            count++;
+        }
+        // 블록 하나가 끝날 때마다 클라이언트로
+        if (!out.flush()) return false;
+    }
+
+    uint8_t end[4] = { uint8_t(count >> 24), uint8_t(count >> 16), uint8_t(count >> 8), uint8_t(count) };
+    stats.record(true, true, count, transfer_length, ms_since(start), blocks, params.symbol_size);
+    return out.send(CodecMsg::END, end, sizeof(end)) && out.flush();
+}
+
+// ==========================================================
+// DECODE: OTI record + PACKET * n + END -> DATA + END
+// ==========================================================
+static bool handle_decode(int fd, CodecWriter& out, const std::vector<uint8_t>& body, DaemonStats& stats)
+{
+    Clock::time_point start = Clock::now();
+    TransferMeta meta;
+    bool framed = false;
+    bool ok = body.size() == 1 + META_RECORD_SIZE && parse_transfer_meta(body.data() + 1, META_RECORD_SIZE, meta) &&
+              meta.has_oti && meta.transfer_length <= CODEC_MAX_MESSAGE;
+    if (ok) framed = (body[0] & CODEC_FLAG_FRAMED) != 0;
+
+    // OTI가 잘못됐어도 END까지는 읽어야 다음 job과 섞이지 않음
+    std::unique_ptr<FecDecoder> fec;
+    if (ok) fec.reset(new FecDecoder(meta));
+    ok = ok && fec->valid();
+
+    CodecMsg type;
+    std::vector<uint8_t> packet;
+    uint64_t bytes = 0;
+    for (;;) {
+        if (!read_codec_message(fd, type, packet)) return false;
+        if (type == CodecMsg::END) break;
+        if (type != CodecMsg::PACKET) {
+            out.send(CodecMsg::ERROR, "DECODE: unexpected message");
+            out.flush();
+            return false;
+        }
+        bytes += packet.size();
+        if (!ok || fec->ready()) continue;
+        if (framed) fec->addFrame(packet.data(), packet.size());
+        else fec->addPacket(packet.data(), packet.size());
+    }
+
+    std::vector<SourceBlock> blocks = fec ? fec->blocks() : std::vector<SourceBlock>();
+    if (!ok) {
+        stats.record(false, false, 0, bytes, ms_since(start), blocks, meta.symbol_size);
+        return out.send(CodecMsg::ERROR, "DECODE: invalid OTI metadata record (or larger than a DATA message)") && out.flush();
+    }
+    if (!fec->ready() || !fec->decode()) {
+        stats.record(false, false, 0, bytes, ms_since(start), blocks, meta.symbol_size);
+        return out.send(CodecMsg::ERROR, "DECODE: not enough valid symbols (" + std::to_string(fec->blocksReady()) + "/" +
+                                         std::to_string(blocks.size()) + " blocks ready)") && out.flush();
+    }
+
+    // 모든 심볼을 이미 받았으므로 reopenBlocks()로 더 받을 수 없음 -> 결과를 보내지 않음
+    FecDecoder::HashStatus hash = fec->hashStatus();
+    bool verified = hash == FecDecoder::HashStatus::MATCH;
+    stats.record(false, hash != FecDecoder::HashStatus::MISMATCH, 0, bytes, ms_since(start), blocks, meta.symbol_size);
+    if (hash == FecDecoder::HashStatus::MISMATCH) return out.send(CodecMsg::ERROR, "DECODE: content hash mismatch") && out.flush();
+    uint8_t status = verified ? CODEC_HASH_VERIFIED : CODEC_HASH_NONE;
+    return out.send(CodecMsg::DATA, fec->data().data(), fec->data().size()) &&
+           out.send(CodecMsg::END, &status, 1) && out.flush();
+}
+
+// 한 연결: 클라이언트가 닫을 때까지 job 반복
+static void serve_client(int fd, DaemonStats& stats)
+{
+    CodecWriter out(fd);
+    CodecMsg type;
+    std::vector<uint8_t> body;
+    while (!g_stop && read_codec_message(fd, type, body)) {
+        if (type == CodecMsg::ENCODE) {
+            if (!handle_encode(out, body, stats)) break;
+        } else if (type == CodecMsg::DECODE) {
+            if (!handle_decode(fd, out, body, stats)) break;
+        } else {
+            out.send(CodecMsg::ERROR, "expected ENCODE or DECODE");
+            out.flush();
+            break;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // ==========================================================
+    // A: Options
+    // ==========================================================
+    std::string socket_path = DEFAULT_CODEC_SOCKET;
+    unsigned workers = 0;
+    size_t cache_mb = 64;
+    for (int i = 1; i < argc; i += 2) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) opt.clear();
+        if (opt == "--socket") socket_path = argv[i + 1];
+        else if (opt == "--workers") workers = static_cast<unsigned>(std::stoul(argv[i + 1]));
+        else if (opt == "--cache") cache_mb = static_cast<size_t>(std::stoul(argv[i + 1]));
+        else {
+            std::cout << "[Error] Usage: ./fec_daemon [--socket PATH] [--workers N] [--cache MB]" << std::endl;
+            std::cout << "  (default socket " << DEFAULT_CODEC_SOCKET << ", --workers = concurrent clients, --cache = RaptorQ matrix cache)" << std::endl;
+            return 1;
+        }
+    }
+
+    // ==========================================================
+    // B: RaptorQ Cache & Socket Setup
+    // ==========================================================
+    // 분해한 행렬을 프로세스 안에 유지 -> (K, T)가 같은 다음 job은 compute_sync가 cache hit
+    size_t cache_bytes = RaptorQ__v1::local_cache_size(cache_mb << 20);
+
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[ERROR] Socket path too long: " << socket_path << std::endl;
+        return 1;
+    }
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path.c_str());
+    if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listen_fd, 16) != 0) {
+        std::cerr << "[ERROR] Cannot listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);      // 클라이언트가 먼저 닫으면 write()가 EPIPE로 실패 (프로세스 종료 없음)
+
+    DaemonStats stats;
+    std::mutex clients_mutex;
+    std::set<int> clients;          // 종료 시 shutdown() -> read()에서 대기 중인 worker를 깨움
+    {
+        ThreadPool pool(workers);
+        std::cout << "--- FEC daemon on " << socket_path << " (" << pool.size() << " workers, RaptorQ cache "
+                  << (cache_bytes >> 20) << " MiB) ---" << std::endl;
+
+        // ==========================================================
+        // C: Accept Loop
+        // ==========================================================
+        while (!g_stop) {
+            struct pollfd pfd = { listen_fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 200) <= 0) continue;
+            int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd < 0) continue;
+            // worker가 모두 바쁘면 연결은 queue에서 대기 (job 처리 순서 = 연결 순서)
+            {
+                std::lock_guard<std::mutex> lock(clients_mutex);
+                clients.insert(fd);
+            }
+            pool.submit([fd, &stats, &clients, &clients_mutex]() {
+                serve_client(fd, stats);
+                std::lock_guard<std::mutex> lock(clients_mutex);
+                clients.erase(fd);
+                close(fd);
+            });
+        }
+        close(listen_fd);
+        unlink(socket_path.c_str());
+        std::lock_guard<std::mutex> lock(clients_mutex);
+        for (int fd : clients) shutdown(fd, SHUT_RDWR);
+    }
+
+    // ==========================================================
+    // D: Summary
+    // ==========================================================
+    std::cout << "\n--- Daemon summary ---" << std::endl;
+    uint64_t jobs = stats.encode_jobs + stats.decode_jobs;
+    std::cout << " Jobs: " << stats.encode_jobs << " encode, " << stats.decode_jobs << " decode, " << stats.failed_jobs << " failed" << std::endl;
+    std::cout << " Packets out: " << stats.packets_out << ", bytes in: " << stats.bytes_in << std::endl;
+    if (jobs > 0) std::cout << " Mean job time: " << stats.busy_ms / jobs << " ms" << std::endl;
+    for (const auto& kv : stats.shapes) {
+        std::cout << "  K=" << kv.first.first << " T=" << kv.first.second << ": " << kv.second << " block(s)" << std::endl;
+    }
+    return 0;
+}
@@ -10,6 +10,7 @@
 
 // ⬅️ Include Base64 header
 #include "base64.h" 
+#include "Base64Simd.hpp"
 
 // --- Image File Encoder (ID-less version) ---
 int main()
@@ -104,6 +105,8 @@ int main()
 
     std::vector<uint8_t> payload(symbol_size); // 32-byte payload buffer
     // [변경] final_packet 버퍼가 필요 없음
+    std::vector<char> line_buf(base64_encoded_size(symbol_size)); // Base64 line buffer (reused)
+    size_t line_len = 0;
 
     for (uint32_t i = 0; i < total_symbols_to_send; ++i) {
 
@@ -123,8 +126,8 @@ int main()
         // [변경] C-4: ID 결합 로직 (final_packet) 제거
         
         // C-5: [변경] 32바이트 페이로드(payload)를 직접 Base64 인코딩
-        std::string base64_output = base64_encode(payload.data(), payload.size());
-        output_file << base64_output << "\n";
+        base64_encode_to(payload.data(), payload.size(), line_buf.data(), line_buf.size(), line_len);
+        output_file.write(line_buf.data(), line_len) << "\n";
     }
 
     output_file.close();
@@ -0,0 +1,186 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <iomanip>
+#include <sstream>
+
+#include "Base64Simd.hpp"
+#include "Feedback.hpp"
+#include "LoRaModule.hpp"
+#include "ReceivePipeline.hpp"
+#include "TransferTable.hpp"
+
+// feedback 프레임을 Base64로 바꿔 pipeline outbox에 넣음 (reader thread가 AT+SEND)
+static void send_feedback(ReceivePipeline& pipeline, const Feedback& fb, int address)
+{
+    std::vector<uint8_t> raw = encode_feedback(fb);
+    std::vector<char> text(base64_encoded_size(raw.size()));
+    size_t text_len = 0;
+    base64_encode_to(raw.data(), raw.size(), text.data(), text.size(), text_len);
+    pipeline.send(std::string(text.data(), text_len), address);
+}
+
+// --- LoRa Gateway (여러 송신 측의 동시 전송 -> 전송별 Decoder -> 출력 디렉터리) ---
+//  - 패킷을 (송신 주소, transfer ID)별로 나눔 (TransferTable), 크기 / T / Z는 각 전송의 OTI record에서
+//  - 블록 디코딩은 worker pool에서 -> 큰 전송의 행렬 디코딩 중에도 다른 전송을 계속 받음
+int main(int argc, char* argv[])
+{
+    // ==========================================================
+    // A: Options
+    // ==========================================================
+    if (argc < 3) {
+        std::cout << "[Error] Usage: ./lora_gateway <serial_port> <output_dir> [--memory MB] [--stale SEC] [--workers N]" << std::endl;
+        std::cout << "                              [--idle-timeout SEC] [--report SEC] [--feedback] [--feedback-gap MS]" << std::endl;
+        std::cout << "  (--idle-timeout 0: run until interrupted)" << std::endl;
+        std::cout << "  Example: ./lora_gateway /dev/ttyUSB1 ../data/gateway --memory 32 --feedback" << std::endl;
+        return 1;
+    }
+
+    const std::string port_name = argv[1];
+    TransferTable::Options table_opt;
+    table_opt.output_dir = argv[2];
+    int idle_timeout_sec = 0;           // 0: 계속 실행
+    int report_sec = 30;                // 전송 / ring 사용량 출력 주기 (0: 끔)
+    bool feedback = false;              // rateless 송신 측마다 DONE / NEED 응답
+    int feedback_gap_ms = 2000;
+
+    for (int i = 3; i < argc; ++i) {
+        std::string opt = argv[i];
+        bool has_value = i + 1 < argc;
+        if (opt == "--memory" && has_value) table_opt.memory_budget = std::stoull(argv[++i]) << 20;
+        else if (opt == "--stale" && has_value) table_opt.stale_ms = std::stoi(argv[++i]) * 1000;
+        else if (opt == "--workers" && has_value) table_opt.workers = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (opt == "--idle-timeout" && has_value) idle_timeout_sec = std::stoi(argv[++i]);
+        else if (opt == "--report" && has_value) report_sec = std::stoi(argv[++i]);
+        else if (opt == "--feedback-gap" && has_value) feedback_gap_ms = std::stoi(argv[++i]);
+        else if (opt == "--feedback") feedback = true;
+        else {
+            std::cerr << "[ERROR] Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // ==========================================================
+    // B: Module & Transfer Table Setup
+    // ==========================================================
+    std::unique_ptr<LoRaModule> module;
+    try {
+        module.reset(new LoRaModule(port_name, B115200));
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+    ReceivePipeline pipeline(*module);
+
+    std::cout << "--- Gateway on " << port_name << " -> " << table_opt.output_dir << "/ (memory budget "
+              << (table_opt.memory_budget >> 20) << " MiB, stale " << table_opt.stale_ms / 1000 << " s) ---" << std::endl;
+
+    // 전송 event 출력 (decoder thread), 완료되면 송신 측에 DONE
+    uint32_t feedback_sent = 0;
+    auto on_event = [&](const TransferTable::Event& e) {
+        std::ostringstream who;
+        who << "[" << e.address << ":" << std::hex << std::setw(8) << std::setfill('0') << e.transfer_id << "]";
+        switch (e.type) {
+        case TransferTable::EventType::STARTED:
+            std::cout << who.str() << " started, " << e.transfer_length << " bytes -> " << e.path << std::endl;
+            break;
+        case TransferTable::EventType::COMPLETED:
+            std::cout << "[SUCCESS] " << who.str() << " " << e.transfer_length << " bytes in " << e.elapsed_s << " s -> " << e.path
+                      << (e.hash_verified ? " (content hash verified)" : " (no content hash)") << std::endl;
+            if (feedback) {
+                Feedback done;
+                done.received = e.symbols_arrived;
+                done.expected = e.symbols_expected;
+                send_feedback(pipeline, done, e.address);
+                feedback_sent++;
+            }
+            break;
+        case TransferTable::EventType::LATE_PACKETS:
+            // 송신 측이 DONE을 받지 못해 repair를 계속 보냄 -> 다시 DONE (TransferTable이 간격 제한)
+            if (feedback) {
+                Feedback done;
+                done.received = e.symbols_arrived;
+                done.expected = e.symbols_expected;
+                send_feedback(pipeline, done, e.address);
+                feedback_sent++;
+                std::cout << "  [feedback] " << who.str() << " DONE resent (packets after completion)" << std::endl;
+            }
+            break;
+        case TransferTable::EventType::REOPENED:
+            std::cerr << "[Warning] " << who.str() << " " << e.reason << ", reopened blocks, waiting for more symbols." << std::endl;
+            break;
+        case TransferTable::EventType::FAILED:
+        case TransferTable::EventType::EVICTED:
+            std::cerr << "[FAILURE] " << who.str() << " " << (e.type == TransferTable::EventType::FAILED ? "failed" : "evicted")
+                      << " (" << e.reason << "). Partial output " << e.path << ": " << e.valid_bytes << "/" << e.transfer_length
+                      << " bytes valid " << e.ranges << std::endl;
+            break;
+        case TransferTable::EventType::REJECTED:
+            std::cerr << "[Warning] " << who.str() << " rejected " << e.transfer_length << "-byte transfer (" << e.reason << ")" << std::endl;
+            break;
+        }
+    };
+    TransferTable table(table_opt, on_event);
+
+    // ==========================================================
+    // C: Receive Pipeline (+RCV= payload -> Base64 -> TransferTable)
+    // ==========================================================
+    auto start = std::chrono::steady_clock::now();
+    auto next_report = start + std::chrono::seconds(report_sec);
+    auto report = [&]() {
+        TransferTable::Stats s = table.stats();
+        std::cout << "  [gateway] active " << s.active << " (decoding " << s.decoding << "), completed " << s.completed
+                  << ", failed " << s.failed << ", evicted " << s.evicted << ", rejected " << s.rejected
+                  << ", memory " << (s.memory_in_use >> 10) << "/" << (table_opt.memory_budget >> 10) << " KiB"
+                  << " (max " << (s.memory_high_water >> 10) << "), packets " << s.packets_routed
+                  << " (replayed " << s.packets_replayed << ", dropped " << s.packets_dropped << ")" << std::endl;
+    };
+    auto consume = [&](const uint8_t* packet, size_t len, int address) {
+        table.addPacket(packet, len, address);
+        if (report_sec > 0 && std::chrono::steady_clock::now() >= next_report) {
+            report();
+            next_report = std::chrono::steady_clock::now() + std::chrono::seconds(report_sec);
+        }
+        return false;       // 계속 수신 (idle timeout / 중단될 때까지)
+    };
+
+    // 패킷이 끊긴 동안: worker 결과 반영 + (feedback) 수신 중인 전송마다 부족한 심볼 수를 NEED로
+    pipeline.setIdleHandler(feedback ? feedback_gap_ms : 200, [&]() {
+        table.poll();
+        if (!feedback) return;
+        table.forEachReceiving([&](int address, const FecDecoder& fec) {
+            Feedback fb;
+            fb.type = FeedbackType::NEED;
+            for (const auto& sb : fec.blocks()) {
+                uint32_t more = fec.symbolsNeeded(sb.sbn);
+                if (more > 0) fb.needs.push_back(BlockNeed{ sb.sbn, static_cast<uint16_t>(std::min<uint32_t>(more, 0xFFFF)) });
+            }
+            if (fb.needs.empty()) return;
+            fb.received = fec.symbolsArrived();
+            fb.expected = fec.symbolsExpected();
+            send_feedback(pipeline, fb, address);
+            feedback_sent++;
+        });
+    });
+    int idle_timeout_ms = idle_timeout_sec > 0 ? idle_timeout_sec * 1000 : std::numeric_limits<int>::max();
+    pipeline.run(consume, idle_timeout_ms, report_sec * 1000);
+    table.drain();
+
+    // ==========================================================
+    // D: Report
+    // ==========================================================
+    ReceivePipeline::Stats stats = pipeline.stats();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  Frames: " << stats.frames << " (rejected " << stats.rejected << ", overruns " << stats.overruns << "), "
+              << elapsed << " s" << std::endl;
+    if (feedback) std::cout << "  Feedback frames sent: " << feedback_sent << std::endl;
+    report();
+    TransferTable::Stats s = table.stats();
+    if (s.active > 0) std::cerr << "[Warning] " << s.active << " incomplete transfer(s) left (partial output kept)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,316 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+
+#include "Base64Simd.hpp"
+#include "FecDecoder.hpp"
+#include "Feedback.hpp"
+#include "ProgressiveFile.hpp"
+#include "Packetizer.hpp"
+#include "LoRaModule.hpp"
+#include "ReceivePipeline.hpp"
+#include "TransferMeta.hpp"
+
+// OTI record를 기다리는 동안 보관할 최대 패킷 수 (그 이후에 도착한 패킷은 버림)
+static const size_t MAX_WAITING_PACKETS = 1024;
+// 복원 후에도 패킷이 오면 (DONE 손실) DONE을 다시 보내는 최소 간격
+static const int DONE_RESEND_MS = 1000;
+
+// feedback 프레임을 Base64로 바꿔 pipeline outbox에 넣음 (reader thread가 AT+SEND)
+static void send_feedback(ReceivePipeline& pipeline, const Feedback& fb, int address)
+{
+    std::vector<uint8_t> raw = encode_feedback(fb);
+    std::vector<char> text(base64_encoded_size(raw.size()));
+    size_t text_len = 0;
+    base64_encode_to(raw.data(), raw.size(), text.data(), text.size(), text_len);
+    pipeline.send(std::string(text.data(), text_len), address);
+}
+
+// --- LoRa Receiver (+RCV= -> RaptorQ Decoder -> 출력 파일, 중간 파일 없음) ---
+//  serial reader / Base64 parser / decoder 를 각각 다른 thread에서 실행 (ReceivePipeline)
+int main(int argc, char* argv[])
+{
+    // ==========================================================
+    // A: Options
+    // ==========================================================
+    if (argc < 3) {
+        std::cout << "[Error] Usage: ./lora_receiver <serial_port> <output_file> [--size BYTES] [--symbol-size N]" << std::endl;
+        std::cout << "                                [--blocks N] [--framed] [--idle-timeout SEC] [--report SEC]" << std::endl;
+        std::cout << "                                [--feedback] [--feedback-gap MS] [--done-linger MS]" << std::endl;
+        std::cout << "  (--size / --symbol-size / --blocks: only for senders without transfer metadata records)" << std::endl;
+        std::cout << "  Example: ./lora_receiver /dev/ttyUSB1 ../data/received_image.jpg" << std::endl;
+        return 1;
+    }
+
+    const std::string port_name = argv[1];
+    const std::string output_filename = argv[2];
+    uint64_t total_data_size = 0;       // 0: 먼저 도착한 metadata record(OTI)에서 F / T / Z를 가져옴
+    uint16_t symbol_size = 0;           // --size일 때 0: 패킷 모드는 32, 프레임 모드는 첫 프레임에서 결정
+    uint32_t min_blocks = 1;
+    bool framed = false;
+    int idle_timeout_sec = 60;          // 이 시간 동안 아무 frame도 없으면 종료
+    int report_sec = 5;                 // ring 사용량 출력 주기 (0: 끔)
+    bool feedback = false;              // rateless 송신(lora_sender --rateless)에 DONE / NEED 응답
+    int feedback_gap_ms = 2000;         // 이 시간 동안 패킷이 없으면 NEED 전송 (송신 측 round 끝)
+    int done_linger_ms = 8000;          // 복원 후 이 시간 동안 패킷이 없을 때까지 대기 (그 사이 패킷마다 DONE 재전송)
+                                        //  - 송신 측 --feedback-timeout(5 s) 뒤의 extra round까지 받을 수 있게
+
+    for (int i = 3; i < argc; ++i) {
+        std::string opt = argv[i];
+        bool has_value = i + 1 < argc;
+        if (opt == "--size" && has_value) total_data_size = std::stoull(argv[++i]);
+        else if (opt == "--symbol-size" && has_value) symbol_size = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else if (opt == "--blocks" && has_value) min_blocks = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (opt == "--idle-timeout" && has_value) idle_timeout_sec = std::stoi(argv[++i]);
+        else if (opt == "--report" && has_value) report_sec = std::stoi(argv[++i]);
+        else if (opt == "--feedback-gap" && has_value) feedback_gap_ms = std::stoi(argv[++i]);
+        else if (opt == "--done-linger" && has_value) done_linger_ms = std::stoi(argv[++i]);
+        else if (opt == "--framed") framed = true;
+        else if (opt == "--feedback") feedback = true;
+        else {
+            std::cerr << "[ERROR] Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // ==========================================================
+    // B: Decoder & Module Setup
+    // ==========================================================
+    if (total_data_size > 0) std::cout << "--- Receiving " << total_data_size << " bytes on " << port_name << " ---" << std::endl;
+    else std::cout << "--- Receiving on " << port_name << " (size from transfer metadata) ---" << std::endl;
+    // 도착한 source symbol은 바로 출력 파일의 제자리에 기록 (블록 디코딩은 빠진 구간만 채움)
+    //  - 출력 파일은 Decoder를 만들 때 정확한 크기로 (OTI record가 먼저 와야 크기를 앎)
+    ProgressiveFile out_file;
+
+    std::unique_ptr<FecDecoder> fec;
+    auto create_decoder = [&](const TransferMeta* oti) {
+        if (oti) {
+            total_data_size = oti->transfer_length;
+            symbol_size = oti->symbol_size;
+            fec.reset(new FecDecoder(*oti));
+        } else {
+            fec.reset(new FecDecoder(total_data_size, symbol_size, min_blocks));
+        }
+        if (!fec->valid()) {
+            std::cerr << "[ERROR] Invalid source block partition" << std::endl;
+            return false;
+        }
+        if (!out_file.open(output_filename, total_data_size)) return false;
+        fec->setOutputSink([&](uint64_t offset, const uint8_t* data, size_t len) {
+            out_file.write(offset, data, len);
+        });
+        std::cout << "  Symbol size: " << symbol_size << ", source blocks (Z): " << fec->blocks().size()
+                  << ", source symbols: " << fec->sourceSymbols();
+        if (oti) std::cout << ", " << total_data_size << " bytes, transfer ID " << oti->transfer_id;
+        std::cout << std::endl;
+        return true;
+    };
+    if (total_data_size > 0) {
+        if (symbol_size == 0 && !framed) symbol_size = 32;
+        if (symbol_size != 0 && !create_decoder(nullptr)) return 1;
+    }
+
+    std::unique_ptr<LoRaModule> module;
+    try {
+        module.reset(new LoRaModule(port_name, B115200));
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+
+    // ==========================================================
+    // C: Receive Pipeline (+RCV= payload -> Base64 -> add_symbol)
+    // ==========================================================
+    uint32_t packets_rejected = 0;
+    bool decode_failed = false;
+    auto start = std::chrono::steady_clock::now();
+    ReceivePipeline pipeline(*module);
+    int sender_address = 0;             // 마지막 패킷을 보낸 주소 (feedback 대상)
+    uint32_t feedback_sent = 0;
+    uint32_t done_resent = 0;
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point last_packet = Clock::now();
+    Clock::time_point last_done;
+
+    // 송신 측이 repair 생성을 멈추도록 DONE (pipeline이 끝나기 전에 reader thread가 보냄)
+    //  - DONE도 손실될 수 있으므로 복원 후 패킷이 계속 오면 DONE_RESEND_MS마다 다시 보냄
+    auto send_done = [&]() {
+        Clock::time_point now = Clock::now();
+        if (feedback_sent > 0 && now - last_done < std::chrono::milliseconds(DONE_RESEND_MS)) return false;
+        Feedback done;
+        done.received = fec->symbolsArrived();
+        done.expected = fec->symbolsExpected();
+        send_feedback(pipeline, done, sender_address);
+        feedback_sent++;
+        last_done = now;
+        return true;
+    };
+
+    // decoder thread: 패킷 추가 + ready가 된 블록은 나머지를 받는 동안 바로 복원
+    auto add_packet = [&](const uint8_t* packet, size_t len, int address) {
+        sender_address = address;
+        last_packet = Clock::now();
+        if (fec->decoded()) {
+            // 복원이 끝난 뒤(--done-linger 동안)에 온 패킷: 송신 측이 DONE을 받지 못함
+            if (send_done()) done_resent++;
+            return false;
+        }
+        FecDecoder::AddResult r = framed ? fec->addFrame(packet, len) : fec->addPacket(packet, len);
+        if (r == FecDecoder::AddResult::BAD_SIZE || r == FecDecoder::AddResult::UNKNOWN_BLOCK) {
+            std::cerr << "[Warning] Unexpected packet (Size: " << len << ", from " << address << "). Ignoring." << std::endl;
+            packets_rejected++;
+            return false;
+        }
+        if (r == FecDecoder::AddResult::BAD_CHECKSUM) return false;     // 손상된 패킷 = 손실 (checksumFailures()로 집계)
+        if (r == FecDecoder::AddResult::METADATA) return false;
+        // rank가 부족한 블록은 decodeReadyBlocks()가 다시 열어 둠 -> 심볼을 더 받음 (다음 NEED에 포함)
+        if (r == FecDecoder::AddResult::ADDED && fec->blocksReady() > 0 && !fec->decodeReadyBlocks()) {
+            decode_failed = true;
+            return true;
+        }
+        // 복원 결과가 metadata의 hash와 다르면 틀린 파일로 끝내지 않고 해당 블록을 다시 받음
+        //  (feedback 모드: 다시 연 블록은 다음 NEED에 포함됨)
+        if (fec->hashStatus() == FecDecoder::HashStatus::MISMATCH) {
+            uint64_t restored_hash = fec->contentHash();
+            size_t reopened = fec->reopenBlocks();
+            std::cerr << "[Warning] Content hash mismatch (xxHash64 " << std::hex << std::setw(16) << std::setfill('0') << restored_hash
+                      << std::dec << std::setfill(' ') << "). Reopened " << reopened << " block(s), waiting for more symbols." << std::endl;
+            return false;
+        }
+        if (fec->decoded() && feedback) {
+            send_done();
+            // DONE이 손실되면 송신 측이 repair를 더 보냄 -> 잠시 더 받으면서 DONE 재전송 (idle handler가 종료)
+            return done_linger_ms <= 0;
+        }
+        return fec->decoded();
+    };
+
+    // Decoder가 없는 동안 (OTI record를 아직 받지 못함) 도착한 패킷은 보관했다가 생성 직후 다시 넣음
+    std::vector<std::pair<std::vector<uint8_t>, int>> waiting;
+    auto consume = [&](const uint8_t* packet, size_t len, int address) {
+        if (fec) return add_packet(packet, len, address);
+
+        TransferMeta oti;
+        FrameView fv;
+        bool created = false;
+        if (parse_transfer_meta(packet, len, oti) && oti.has_oti) {
+            // 먼저 도착한 OTI record로 Decoder 생성 (hash 등록 포함)
+            if (!create_decoder(&oti)) {
+                decode_failed = true;
+                return true;
+            }
+            created = true;
+        } else if (total_data_size > 0 && parse_frame(packet, len, fv)) {
+            // --size + 프레임 모드: T = (길이 - 5) / n 을 첫 번째 정상 프레임에서 가져옴
+            symbol_size = fv.symbol_size;
+            if (!create_decoder(nullptr)) {
+                decode_failed = true;
+                return true;
+            }
+            created = true;
+        }
+        if (!created) {
+            if (waiting.size() < MAX_WAITING_PACKETS) waiting.emplace_back(std::vector<uint8_t>(packet, packet + len), address);
+            else packets_rejected++;
+            return false;
+        }
+
+        bool done = add_packet(packet, len, address);
+        for (size_t i = 0; i < waiting.size() && !done; ++i) {
+            done = add_packet(waiting[i].first.data(), waiting[i].first.size(), waiting[i].second);
+        }
+        if (!waiting.empty()) std::cout << "  Replayed " << waiting.size() << " packet(s) received before the metadata record" << std::endl;
+        waiting.clear();
+        waiting.shrink_to_fit();
+        return done;
+    };
+
+    // 송신 측 round가 끝나서 패킷이 끊기면 블록별로 부족한 심볼 수를 알려 줌 (decoder thread)
+    if (feedback) {
+        pipeline.setIdleHandler(feedback_gap_ms, [&]() {
+            if (fec && fec->decoded()) {
+                if (Clock::now() - last_packet >= std::chrono::milliseconds(done_linger_ms)) pipeline.finish();
+                return;
+            }
+            if (!fec || sender_address == 0) return;
+            Feedback fb;
+            fb.type = FeedbackType::NEED;
+            for (const auto& sb : fec->blocks()) {
+                uint32_t more = fec->symbolsNeeded(sb.sbn);
+                if (more > 0) fb.needs.push_back(BlockNeed{ sb.sbn, static_cast<uint16_t>(std::min<uint32_t>(more, 0xFFFF)) });
+            }
+            if (fb.needs.empty()) return;
+            fb.received = fec->symbolsArrived();
+            fb.expected = fec->symbolsExpected();
+            send_feedback(pipeline, fb, sender_address);
+            feedback_sent++;
+            std::cout << "  [feedback] NEED sent for " << std::min(fb.needs.size(), FEEDBACK_MAX_BLOCKS) << "/" << fb.needs.size()
+                      << " unfinished block(s), first: SBN "
+                      << static_cast<int>(fb.needs[0].sbn) << " +" << fb.needs[0].more << std::endl;
+        });
+    }
+    pipeline.run(consume, idle_timeout_sec * 1000, report_sec * 1000);
+    ReceivePipeline::Stats stats = pipeline.stats();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  Frames: " << stats.frames << " (rejected " << (stats.rejected + packets_rejected)
+              << ", overruns " << stats.overruns << ")"
+              << ", valid symbols: " << (fec ? fec->received() : 0)
+              << ", CRC failures: " << (fec ? fec->checksumFailures() : 0)
+              << ", ring max " << stats.raw_high_water << "/" << stats.packet_high_water
+              << ", " << elapsed << " s" << std::endl;
+    if (feedback) std::cout << "  Feedback frames sent: " << feedback_sent << " (DONE resent " << done_resent << ")" << std::endl;
+    if (fec && fec->hashMismatches() > 0) std::cout << "  Content hash mismatches: " << fec->hashMismatches() << std::endl;
+
+    // ==========================================================
+    // D: Decode & Save
+    // ==========================================================
+    // 실패해도 받은 source symbol은 출력 파일에 남음 -> 유효 구간을 알려 줌
+    auto report_partial = [&]() {
+        if (!fec || !fec->valid()) return;
+        std::cerr << "  Partial output " << output_filename << ": " << fec->validBytes() << "/" << total_data_size
+                  << " bytes valid " << format_ranges(fec->validRanges()) << std::endl;
+    };
+    if (decode_failed) {
+        std::cerr << "[FAILURE] Decode failed." << std::endl;
+        report_partial();
+        return 1;
+    }
+    if (!fec || !fec->ready()) {
+        std::cerr << "[FAILURE] Decode failed. Not enough valid symbols received." << std::endl;
+        if (!fec && !waiting.empty()) {
+            std::cerr << "  (" << waiting.size() << " packets received, but no transfer metadata record. Use --size for senders without one.)" << std::endl;
+        }
+        if (fec) {
+            std::cerr << "  (" << fec->blocksReady() << "/" << fec->blocks().size() << " blocks ready, received " << fec->received()
+                      << " valid symbols, needed " << fec->sourceSymbols() << ")" << std::endl;
+        }
+        report_partial();
+        return 1;
+    }
+
+    if (!fec->decode()) {
+        if (!fec->ready()) std::cerr << "[FAILURE] Decode failed. Rank deficient block(s), more symbols needed." << std::endl;
+        else std::cerr << "[FAILURE] Decode failed." << std::endl;
+        report_partial();
+        return 1;
+    }
+    if (fec->hashStatus() == FecDecoder::HashStatus::MISMATCH) {
+        std::cerr << "[FAILURE] Decode failed. Content hash mismatch (restored data differs from the source)." << std::endl;
+        fec->reopenBlocks();
+        report_partial();
+        return 1;
+    }
+    if (fec->hashStatus() == FecDecoder::HashStatus::MATCH) std::cout << "  Content hash verified (xxHash64)" << std::endl;
+    else std::cout << "  [Warning] No transfer metadata received, content hash not verified" << std::endl;
+    out_file.close();
+    std::cout << "  Source blocks: " << fec->blocks().size() << " (" << fec->fastPathBlocks()
+              << " restored from source symbols only)" << std::endl;
+    std::cout << "[SUCCESS] Decode complete! Restored data saved to " << output_filename << std::endl;
+
+    return 0;
+}
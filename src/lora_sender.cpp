@@ -0,0 +1,408 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <iterator>
+#include <chrono>
+#include <algorithm>
+
+#include "Base64Simd.hpp"
+#include "Feedback.hpp"
+#include "LoRaModule.hpp"
+#include "LoRaTxQueue.hpp"
+#include "LossEstimator.hpp"
+#include "PacketContainer.hpp"
+#include "RatelessEncoder.hpp"
+#include "TransferMeta.hpp"
+#include "XxHash64.hpp"
+
+static void print_stats(const LoRaTxQueue::Stats& s)
+{
+    std::cout << " sent " << s.sent << ", failed " << s.failed
+              << ", queue " << s.depth << " (max " << s.max_depth << ")"
+              << ", " << s.packets_per_sec << " packets/s" << std::endl;
+}
+
+// +RCV payload(Base64)가 feedback 프레임이면 true
+static bool decode_feedback(const LoRaFrame& frame, Feedback& fb)
+{
+    std::vector<uint8_t> raw(base64_decoded_max_size(frame.data.size()));
+    size_t raw_len = 0;
+    return base64_decode_to(frame.data.data(), frame.data.size(), raw.data(), raw.size(), raw_len) == Base64Status::OK &&
+           parse_feedback(raw.data(), raw_len, fb);
+}
+
+// 마지막 수신 측 report로 주소별 손실률 추정치 갱신 + 전송 결과 기록 (인코더의 adaptive overhead 입력)
+//  - outcome_known == false: 결과를 모름 (DONE 손실일 수 있음) -> 성공 / 실패 통계에 넣지 않음
+static void record_report(const std::string& estimator_path, int address, const Feedback& report, bool success,
+                          bool outcome_known = true)
+{
+    LossEstimator estimator;
+    estimator.load(estimator_path);
+    if (report.expected > 0) {
+        double observed = 1.0 - static_cast<double>(std::min(report.received, report.expected)) / report.expected;
+        double loss = estimator.update(address, report.received, report.expected);
+        std::cout << " Loss report: " << report.received << "/" << report.expected << " symbols arrived ("
+                  << 100.0 * observed << "% lost), estimate for address " << address << " -> " << 100.0 * loss << "%" << std::endl;
+    }
+    if (outcome_known) estimator.recordOutcome(address, success);
+    LinkEstimate e = estimator.get(address);
+    std::cout << " Observed success: " << e.successes << "/" << e.transfers << " transfers to address " << address << std::endl;
+    if (!estimator.save(estimator_path)) {
+        std::cerr << "[Warning] Cannot write loss estimate file " << estimator_path << std::endl;
+    }
+}
+
+struct RatelessOptions {
+    uint16_t symbol_size = 32;
+    uint32_t min_blocks = 1;
+    double overhead_ratio = 0.0;    // 첫 round에서 source 뒤에 보낼 repair (%)
+    int feedback_timeout_ms = 5000; // round가 끝난 뒤 feedback을 기다리는 시간
+    uint32_t max_rounds = 20;       // 추가 round 상한 (feedback이 없는 round 포함)
+    uint32_t max_silent = 3;        // feedback 없는 round가 연속으로 이만큼이면 중단 (결과 모름)
+    uint32_t extra = 1;             // NEED N 에 더해서 보낼 repair 수 (다음 round 손실 대비)
+    std::string estimator_path = DEFAULT_LOSS_ESTIMATE_FILE;
+    PacketFormat format;            // --id compact: 1~3 bytes varint Payload ID, --check crc32c: CRC trailer
+};
+
+// ==========================================================
+// Rateless send-until-done
+//  - source + (선택) 초기 repair를 보낸 뒤 수신 측 feedback을 기다림
+//    · NEED: 블록별로 요청한 수 + extra 만큼 새 repair symbol 생성/전송
+//    · DONE: 즉시 종료 (round 도중에도 +OK 사이에 확인)
+//    · timeout: feedback이 손실됐다고 보고 미완료 블록마다 extra개씩 보냄
+//      (max_silent round 연속으로 응답이 없으면 중단: 복원 후 DONE만 손실됐을 수 있으므로 실패가 아니라 "모름")
+//  - 송신 thread(LoRaTxQueue) 대신 직접 sendData(): serial을 읽는 쪽이 하나여야 feedback을 놓치지 않음
+// ==========================================================
+static int run_rateless(LoRaModule& module, int address, const std::string& input_filename, const RatelessOptions& opt)
+{
+    std::ifstream input_file(input_filename, std::ios::binary);
+    if (!input_file) {
+        std::cerr << "Error: Cannnot open input File " << input_filename << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(input_file)), std::istreambuf_iterator<char>());
+    const size_t data_size = data.size();
+    const uint64_t content_hash = xxh64(data.data(), data.size());
+
+    RatelessEncoder encoder(std::move(data), opt.symbol_size, opt.min_blocks);
+    if (!encoder.valid()) {
+        std::cerr << "Encoder pre-computation failed" << std::endl;
+        return 1;
+    }
+    const size_t num_blocks = encoder.blocks().size();
+    // OTI + hash record: 수신 측은 --size 등 없이 이 record로 Decoder를 만듦
+    const TransferMeta meta = make_transfer_meta(data_size, opt.symbol_size, static_cast<uint16_t>(num_blocks),
+                                                 static_cast<uint16_t>(encoder.blocks()[0].block), true, content_hash);
+    std::cout << "--- Rateless transfer: " << data_size << " bytes, T=" << opt.symbol_size << ", Z=" << num_blocks
+              << ", transfer ID " << meta.transfer_id << " (receiver: --feedback) ---" << std::endl;
+
+    std::vector<uint8_t> packet(encoder.packetSize());
+    std::vector<uint8_t> formatted(packet_buffer_size(opt.symbol_size));
+    PacketFormat format = opt.format;
+    format.sbn_bits = sbn_bits_for(num_blocks);
+    std::vector<char> line_buf(base64_encoded_size(std::max(formatted.size(), META_RECORD_SIZE)));
+    std::vector<bool> block_done(num_blocks, false);
+    uint64_t sent = 0, failed = 0, repair_sent = 0;
+    bool done = false;
+    auto start = std::chrono::steady_clock::now();
+
+    // feedback 한 개 처리 (DONE이면 done = true)
+    Feedback last_report;
+    auto handle_feedback = [&](const LoRaFrame& frame, bool& got_need, std::vector<uint32_t>& need) {
+        Feedback fb;
+        if (!decode_feedback(frame, fb)) return;
+        if (fb.expected > 0) last_report = fb;
+        if (fb.type == FeedbackType::DONE) {
+            done = true;
+            return;
+        }
+        // NEED에 없는 블록은 이미 ready
+        std::vector<bool> listed(num_blocks, false);
+        for (const auto& n : fb.needs) {
+            if (n.sbn >= num_blocks) continue;
+            listed[n.sbn] = true;
+            need[n.sbn] = n.more;
+            block_done[n.sbn] = false;      // hash 불일치로 수신 측이 다시 연 블록
+        }
+        if (fb.needs.size() < FEEDBACK_MAX_BLOCKS) {
+            for (size_t b = 0; b < num_blocks; ++b) if (!listed[b]) block_done[b] = true;
+        }
+        got_need = true;
+    };
+
+    // metadata record (OTI + xxHash64): round 0의 처음, META_REPEAT_INTERVAL개의 패킷마다, 끝
+    //  + 추가 round의 처음 (앞의 record를 모두 놓친 수신 측도 Decoder를 만들 수 있게)
+    uint8_t meta_record[META_RECORD_SIZE];
+    encode_transfer_meta(meta, meta_record);
+    uint64_t since_meta = 0;
+    auto send_meta = [&]() {
+        size_t line_len = 0;
+        base64_encode_to(meta_record, META_RECORD_SIZE, line_buf.data(), line_buf.size(), line_len);
+        if (!module.sendData(std::string(line_buf.data(), line_len), address)) failed++;
+        since_meta = 0;
+    };
+
+    // 패킷 하나 전송 후, +OK를 기다리는 동안 쌓인 feedback 확인
+    std::vector<uint32_t> pending_need(num_blocks, 0);
+    bool pending = false;
+    auto send_packet = [&]() {
+        size_t line_len = 0;
+        size_t len = format_packet(packet.data(), opt.symbol_size, format, formatted.data());
+        base64_encode_to(formatted.data(), len, line_buf.data(), line_buf.size(), line_len);
+        if (module.sendData(std::string(line_buf.data(), line_len), address)) sent++;
+        else failed++;
+        LoRaFrame frame;
+        while (!done && module.receive(frame, 0)) handle_feedback(frame, pending, pending_need);
+        if (!done && ++since_meta == META_REPEAT_INTERVAL) send_meta();
+    };
+
+    // C-1: Round 0 - source symbol 전부 + 초기 repair
+    send_meta();
+    for (const auto& sb : encoder.blocks()) {
+        for (uint32_t esi = 0; esi < static_cast<uint32_t>(sb.block) && !done; ++esi) {
+            encoder.sourcePacket(sb.sbn, esi, packet.data());
+            send_packet();
+        }
+        uint32_t initial = repair_symbol_count(static_cast<uint32_t>(sb.block), opt.overhead_ratio);
+        for (uint32_t r = 0; r < initial && !done && encoder.nextRepairPacket(sb.sbn, packet.data()); ++r) {
+            send_packet();
+            repair_sent++;
+        }
+    }
+    if (!done && since_meta > 0) send_meta();
+
+    // C-2: feedback이 올 때까지 대기 -> 요청한 만큼 repair 추가
+    uint32_t round = 0;
+    uint32_t silent = 0;            // 연속으로 feedback이 없었던 round
+    while (!done && round < opt.max_rounds) {
+        if (!pending) {
+            LoRaFrame frame;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(opt.feedback_timeout_ms);
+            while (!done && !pending) {
+                int remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count());
+                if (remaining <= 0 || !module.receive(frame, remaining)) break;
+                handle_feedback(frame, pending, pending_need);
+            }
+            if (done) break;
+        }
+        silent = pending ? 0 : silent + 1;
+        if (silent > opt.max_silent) break;
+        round++;
+
+        std::vector<uint32_t> plan(num_blocks, 0);
+        for (size_t b = 0; b < num_blocks; ++b) {
+            if (block_done[b]) continue;
+            // NEED가 없으면 (feedback 손실) 미완료 블록마다 extra개만
+            plan[b] = (pending ? pending_need[b] : 0) + opt.extra;
+        }
+        std::cout << "  [round " << round << "] " << (pending ? "NEED" : "no feedback") << ", sending";
+        for (size_t b = 0; b < num_blocks; ++b) if (plan[b]) std::cout << " SBN " << b << " +" << plan[b];
+        std::cout << std::endl;
+        pending = false;
+        std::fill(pending_need.begin(), pending_need.end(), 0);
+        send_meta();
+
+        for (size_t b = 0; b < num_blocks && !done; ++b) {
+            for (uint32_t r = 0; r < plan[b] && !done && encoder.nextRepairPacket(static_cast<uint8_t>(b), packet.data()); ++r) {
+                send_packet();
+                repair_sent++;
+            }
+        }
+    }
+
+    // ==========================================================
+    // D: Report
+    // ==========================================================
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << " sent " << sent << " (repair " << repair_sent << "), failed " << failed
+              << ", rounds " << round << ", " << elapsed << " s" << std::endl;
+    if (!done && silent > opt.max_silent) {
+        // 수신 측은 DONE을 보낸 뒤 잠시(--done-linger)만 더 들음 -> 그 뒤의 침묵은 성공 / 실패를 구분할 수 없음
+        record_report(opt.estimator_path, address, last_report, false, false);
+        std::cerr << "[Warning] No feedback for " << opt.max_silent << " rounds. Outcome unknown"
+                  << " (the receiver may have restored the file and its DONE was lost)." << std::endl;
+        return 2;
+    }
+    record_report(opt.estimator_path, address, last_report, done);
+    if (!done) {
+        std::cerr << "[FAILURE] No DONE from receiver after " << round << " rounds." << std::endl;
+        return 1;
+    }
+    std::cout << "[SUCCESS] Receiver reported DONE (" << sent << " packets sent to address " << address << ")" << std::endl;
+    return 0;
+}
+
+// --- LoRa Sender (인코딩된 .txt / .fecb 파일을 모듈로 전송) ---
+int main(int argc, char* argv[])
+{
+    // ==========================================================
+    // A: Options
+    // ==========================================================
+    if (argc < 3) {
+        std::cout << "[Error] Usage: ./lora_sender <serial_port> <encoded_file> [--address N] [--queue N] [--timeout MS]" << std::endl;
+        std::cout << "       ./lora_sender <serial_port> <raw_file> --rateless [--address N] [--symbol-size N] [--blocks N]" << std::endl;
+        std::cout << "                     [--overhead P] [--feedback-timeout MS] [--max-rounds N] [--max-silent N] [--extra N]" << std::endl;
+        std::cout << "       common: [--estimator FILE] [--report-wait MS] (wait for the receiver's loss report after sending)" << std::endl;
+        std::cout << "               [--id full|compact] (rateless / .fecb input: send 1-3 byte Payload IDs)" << std::endl;
+        std::cout << "               [--check none|crc32c] (rateless / .fecb input: append a CRC32C to each packet)" << std::endl;
+        std::cout << "  Example: ./lora_sender /dev/ttyUSB0 ../data/encoded_correct.txt --address 2" << std::endl;
+        std::cout << "  Example: ./lora_sender /dev/ttyUSB0 ../data/sample_image.jpg --rateless --address 2" << std::endl;
+        return 1;
+    }
+
+    const std::string port_name = argv[1];
+    const std::string input_filename = argv[2];
+    int address = 0;
+    size_t queue_capacity = 64;
+    int response_timeout_ms = 0;    // 0: LoRaModule 기본값 (SF가 크면 airtime보다 길게 줘야 함)
+    bool rateless = false;          // 입력은 원본 파일, 수신 측(lora_receiver --feedback)이 DONE을 보낼 때까지 repair 생성
+    RatelessOptions rateless_opt;
+    int report_wait_ms = 0;         // > 0: 전송 후 수신 측 report(lora_receiver --feedback)를 기다려 손실률 추정치 갱신
+
+    for (int i = 3; i < argc; i += 2) {
+        std::string opt = argv[i];
+        if (opt == "--rateless") {
+            rateless = true;
+            --i;        // 값 없는 옵션
+            continue;
+        }
+        if (i + 1 >= argc) opt.clear();
+        if (opt == "--address") address = std::stoi(argv[i + 1]);
+        else if (opt == "--timeout") response_timeout_ms = std::stoi(argv[i + 1]);
+        else if (opt == "--queue") queue_capacity = static_cast<size_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--symbol-size") rateless_opt.symbol_size = static_cast<uint16_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--blocks") rateless_opt.min_blocks = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--overhead") rateless_opt.overhead_ratio = std::stod(argv[i + 1]);
+        else if (opt == "--feedback-timeout") rateless_opt.feedback_timeout_ms = std::stoi(argv[i + 1]);
+        else if (opt == "--max-rounds") rateless_opt.max_rounds = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--max-silent") rateless_opt.max_silent = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--extra") rateless_opt.extra = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--estimator") rateless_opt.estimator_path = argv[i + 1];
+        else if (opt == "--report-wait") report_wait_ms = std::stoi(argv[i + 1]);
+        else if (opt == "--id" && (std::string(argv[i + 1]) == "full" || std::string(argv[i + 1]) == "compact")) {
+            rateless_opt.format.compact_id = std::string(argv[i + 1]) == "compact";
+        }
+        else if (opt == "--check" && (std::string(argv[i + 1]) == "none" || std::string(argv[i + 1]) == "crc32c")) {
+            rateless_opt.format.crc = std::string(argv[i + 1]) == "crc32c";
+        }
+        else {
+            std::cerr << "[ERROR] Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // ==========================================================
+    // B: Module Setup
+    // ==========================================================
+    std::unique_ptr<LoRaModule> module;
+    try {
+        module.reset(new LoRaModule(port_name, B115200));
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+    if (response_timeout_ms > 0) module->setResponseTimeout(response_timeout_ms);
+    if (!module->checkConnection()) {
+        std::cerr << "[ERROR] No response to AT from " << port_name << std::endl;
+        return 1;
+    }
+    if (rateless) return run_rateless(*module, address, input_filename, rateless_opt);
+
+    // ==========================================================
+    // C: Push packets (전송은 LoRaTxQueue thread에서)
+    // ==========================================================
+    LoRaTxQueue queue(*module, address, queue_capacity);
+    uint64_t pushed = 0;
+
+    if (ContainerReader::isContainer(input_filename)) {
+        ContainerReader container;
+        if (!container.open(input_filename)) {
+            std::cerr << "Error: Cannnot open input File " << input_filename << std::endl;
+            return 1;
+        }
+        // --id / --check: 레코드를 전송 직전에 변환 (컨테이너 파일은 그대로)
+        //  - CRC가 붙은 레코드([4B ID | symbol | CRC])는 ID를 바꾸면 CRC를 다시 계산
+        const ContainerHeader& header = container.header();
+        const bool has_crc = container.recordSize() == packet_buffer_size(header.symbol_size);
+        PacketFormat format = rateless_opt.format;
+        format.sbn_bits = sbn_bits_for(header.num_blocks);
+        format.crc = format.crc || has_crc;
+        const bool convert = format.compact_id || (format.crc && !has_crc);
+        std::vector<uint8_t> formatted(packet_buffer_size(header.symbol_size));
+        std::vector<char> line_buf(base64_encoded_size(std::max({ container.recordSize(), formatted.size(), META_RECORD_SIZE })));
+        size_t line_len = 0;
+        // 헤더의 OTI (+ v2 컨테이너는 hash)로 metadata record를 만들어
+        // 처음, META_REPEAT_INTERVAL개의 레코드마다, 끝에 전송
+        const TransferMeta meta = make_transfer_meta(header.transfer_length, header.symbol_size, header.num_blocks,
+                                                     static_cast<uint16_t>(header.num_source_symbols),
+                                                     header.has_hash, header.content_hash);
+        uint8_t meta_record[META_RECORD_SIZE];
+        encode_transfer_meta(meta, meta_record);
+        auto push_meta = [&]() {
+            base64_encode_to(meta_record, META_RECORD_SIZE, line_buf.data(), line_buf.size(), line_len);
+            return queue.push(std::string(line_buf.data(), line_len));
+        };
+        bool pushing = push_meta();
+        for (size_t i = 0; pushing && i < container.size(); ++i) {
+            const uint8_t* record = container.record(i);
+            size_t record_len = container.recordSize();
+            if (convert) {
+                record_len = format_packet(record, header.symbol_size, format, formatted.data());
+                record = formatted.data();
+            }
+            base64_encode_to(record, record_len, line_buf.data(), line_buf.size(), line_len);
+            if (!queue.push(std::string(line_buf.data(), line_len))) {
+                pushing = false;
+                break;
+            }
+            if (++pushed % 100 == 0) print_stats(queue.stats());
+            if (pushed % META_REPEAT_INTERVAL == 0 && !push_meta()) pushing = false;
+        }
+        if (pushing && pushed % META_REPEAT_INTERVAL != 0) push_meta();
+    } else {
+        std::ifstream input_file(input_filename);
+        if (!input_file) {
+            std::cerr << "Error: Cannnot open input File " << input_filename << std::endl;
+            return 1;
+        }
+        std::string line;
+        while (std::getline(input_file, line)) {
+            if (line.empty()) continue;
+            if (!queue.push(line)) break;
+            if (++pushed % 100 == 0) print_stats(queue.stats());
+        }
+    }
+
+    // ==========================================================
+    // D: Drain & Report
+    // ==========================================================
+    queue.close();
+    LoRaTxQueue::Stats stats = queue.stats();
+    print_stats(stats);
+    if (stats.failed > 0) {
+        std::cerr << "[Warning] " << stats.failed << " of " << pushed << " packets were not acknowledged." << std::endl;
+    }
+    std::cout << "[SUCCESS] " << stats.sent << " packets sent to address " << address << std::endl;
+
+    // D-1: 수신 측 report (DONE = 복원 성공, NEED = 보낸 것으로 부족) -> 손실률 추정치
+    //      전송 중에 도착한 DONE은 LoRaModule의 frame queue에 남아 있음
+    if (report_wait_ms > 0) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(report_wait_ms);
+        LoRaFrame frame;
+        Feedback report;
+        bool got_report = false;
+        while (!got_report) {
+            int remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count());
+            if (remaining < 0 || !module->receive(frame, remaining)) break;
+            got_report = decode_feedback(frame, report);
+        }
+        if (got_report) record_report(rateless_opt.estimator_path, address, report, report.type == FeedbackType::DONE);
+        else std::cerr << "[Warning] No report from receiver within " << report_wait_ms << " ms" << std::endl;
+    }
+
+    return 0;
+}
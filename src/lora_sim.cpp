@@ -0,0 +1,283 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "LoRaAirtime.hpp"
+
+// --- LoRa Module Simulator (PTY, RYLR 계열 AT 명령) ---
+//  - PTY N개(node 0 .. N-1, 기본 2개)를 만들고 한 node의 AT+SEND를 주소가 맞는 다른 node들에 +RCV=로 전달
+//    (주소 0 = broadcast, --nodes 3 이상이면 여러 송신 측 -> gateway 한 대 구성)
+//  - +OK는 airtime(SF/BW/CR) + UART 시간이 지난 뒤에 응답 (실제 모듈처럼 전송 중에는 busy)
+//  - --loss 확률로 패킷을 버리고, --latency 만큼 수신을 늦춤
+//  - LoRaModule은 장치 경로만 바꾸면 그대로 연결됨 (예: /tmp/lora0)
+
+using Clock = std::chrono::steady_clock;
+
+static volatile std::sig_atomic_t g_stop = 0;
+static void on_signal(int) { g_stop = 1; }
+
+const size_t MAX_PAYLOAD = 240;     // RYLR AT+SEND 최대 길이
+
+struct Node {
+    int master = -1;
+    int slave = -1;                 // 직접 열어 둠: client가 닫아도 master에 POLLHUP가 계속 뜨지 않도록
+    std::string path;
+    int address = 0;
+    std::string pending;            // 아직 \r\n이 오지 않은 명령
+    Clock::time_point busy_until;   // 전송 중이면 다음 명령은 이 시각 이후에 처리
+};
+
+struct Stats {
+    uint64_t sent = 0;
+    uint64_t lost = 0;
+    uint64_t delivered = 0;
+    double airtime_ms = 0.0;
+};
+
+static bool open_node(Node& node)
+{
+    node.master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (node.master < 0 || grantpt(node.master) != 0 || unlockpt(node.master) != 0) return false;
+    const char* name = ptsname(node.master);
+    if (!name) return false;
+    node.path = name;
+    node.slave = open(name, O_RDWR | O_NOCTTY);
+    if (node.slave < 0) return false;
+
+    struct termios tty;
+    if (tcgetattr(node.slave, &tty) != 0) return false;
+    cfmakeraw(&tty);
+    if (tcsetattr(node.slave, TCSANOW, &tty) != 0) return false;
+    fcntl(node.master, F_SETFL, fcntl(node.master, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+// master는 non-blocking -> 짧은 write면 나머지를 이어서 씀 (client가 읽지 않아 PTY buffer가 차면 잠시 기다림)
+//  - WRITE_TIMEOUT_MS 동안 공간이 나지 않으면 포기 (시뮬레이터 전체가 한 node에 묶이지 않도록)
+const int WRITE_TIMEOUT_MS = 1000;
+
+static bool write_all(int fd, const char* data, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n > 0) {
+            data += n;
+            len -= static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return false;
+        struct pollfd pfd = { fd, POLLOUT, 0 };
+        int ready = poll(&pfd, 1, WRITE_TIMEOUT_MS);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready == 0) errno = ETIMEDOUT;
+        if (ready <= 0) return false;
+    }
+    return true;
+}
+
+static Clock::time_point after_ms(Clock::time_point t, double ms)
+{
+    return t + std::chrono::microseconds(static_cast<int64_t>(ms * 1000.0));
+}
+
+int main(int argc, char* argv[])
+{
+    // ==========================================================
+    // A: Options
+    // ==========================================================
+    LoRaParams params;
+    uint32_t baud_rate = 115200;
+    double loss = 0.0;
+    double latency_ms = 0.0;
+    std::string link_prefix;
+    uint32_t seed = 1;
+    int num_nodes = 2;
+
+    for (int i = 1; i < argc; i += 2) {
+        std::string opt = argv[i];
+        if (i + 1 >= argc) opt.clear();
+        if (opt == "--sf") params.spreading_factor = static_cast<unsigned>(std::stoul(argv[i + 1]));
+        else if (opt == "--bw") params.bandwidth_hz = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--cr") params.coding_rate = static_cast<unsigned>(std::stoul(argv[i + 1]));
+        else if (opt == "--baud") baud_rate = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--loss") loss = std::stod(argv[i + 1]);
+        else if (opt == "--latency") latency_ms = std::stod(argv[i + 1]);
+        else if (opt == "--link") link_prefix = argv[i + 1];
+        else if (opt == "--seed") seed = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (opt == "--nodes") num_nodes = std::atoi(argv[i + 1]);
+        else {
+            std::cout << "[Error] Usage: ./lora_sim [--sf 7-12] [--bw HZ] [--cr 1-4] [--baud N] [--loss P] [--latency MS] [--link PREFIX] [--seed N] [--nodes N]" << std::endl;
+            std::cout << "  Example: ./lora_sim --sf 9 --loss 0.1 --link /tmp/lora   (-> /tmp/lora0, /tmp/lora1)" << std::endl;
+            return 1;
+        }
+    }
+    if (num_nodes < 2 || num_nodes > 16) {
+        std::cerr << "[ERROR] --nodes must be 2-16" << std::endl;
+        return 1;
+    }
+    if (params.spreading_factor < 7 || params.spreading_factor > 12 || params.coding_rate < 1 || params.coding_rate > 4) {
+        std::cerr << "[ERROR] SF must be 7-12 and CR 1-4" << std::endl;
+        return 1;
+    }
+    if (!lora_bandwidth_valid(params.bandwidth_hz)) {
+        std::cerr << "[ERROR] BW must be 125000, 250000 or 500000" << std::endl;
+        return 1;
+    }
+
+    // ==========================================================
+    // B: PTY Setup
+    // ==========================================================
+    std::vector<Node> nodes(num_nodes);
+    for (int n = 0; n < num_nodes; ++n) {
+        if (!open_node(nodes[n])) {
+            std::cerr << "[ERROR] Cannot create pseudo-terminal: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        nodes[n].address = n + 1;
+        if (!link_prefix.empty()) {
+            std::string link = link_prefix + std::to_string(n);
+            unlink(link.c_str());
+            if (symlink(nodes[n].path.c_str(), link.c_str()) != 0) {
+                std::cerr << "[Warning] Cannot create link " << link << std::endl;
+            } else {
+                nodes[n].path = link;
+            }
+        }
+        std::cout << "node " << n << " (address " << nodes[n].address << "): " << nodes[n].path << std::endl;
+    }
+    std::cout << " SF" << params.spreading_factor << " BW " << params.bandwidth_hz << " CR 4/" << (params.coding_rate + 4)
+              << ", loss " << loss << ", latency " << latency_ms << " ms, baud " << baud_rate << std::endl;
+    std::cout << " Airtime (36B): " << lora_airtime_ms(params, 36) << " ms" << std::endl;
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    // ==========================================================
+    // C: Event Loop (명령 수신 -> 예약된 응답을 시각 순서대로 write)
+    // ==========================================================
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::multimap<Clock::time_point, std::pair<int, std::string>> scheduled;   // (시각, (node, 출력))
+    Stats stats;
+
+    // node n에 응답 예약 (UART로 내보내는 시간 포함)
+    auto schedule = [&](int n, Clock::time_point at, const std::string& text) {
+        scheduled.emplace(after_ms(at, uart_delay_ms(text.size(), baud_rate)), std::make_pair(n, text));
+    };
+
+    auto handle_command = [&](int n, const std::string& cmd) {
+        Node& node = nodes[n];
+        Clock::time_point start = std::max(Clock::now(), node.busy_until);
+
+        if (cmd.compare(0, 2, "AT") != 0) {
+            schedule(n, start, "+ERR=2\r\n");
+        } else if (cmd == "AT") {
+            schedule(n, start, "+OK\r\n");
+        } else if (cmd.compare(0, 11, "AT+ADDRESS=") == 0) {
+            node.address = std::atoi(cmd.c_str() + 11);
+            schedule(n, start, "+OK\r\n");
+        } else if (cmd.compare(0, 8, "AT+SEND=") == 0) {
+            // AT+SEND=<address>,<length>,<data>
+            size_t c1 = cmd.find(',', 8);
+            size_t c2 = c1 == std::string::npos ? c1 : cmd.find(',', c1 + 1);
+            if (c2 == std::string::npos) {
+                schedule(n, start, "+ERR=4\r\n");
+                return;
+            }
+            int dest = std::atoi(cmd.c_str() + 8);
+            size_t length = static_cast<size_t>(std::atoi(cmd.c_str() + c1 + 1));
+            std::string data = cmd.substr(c2 + 1);
+            if (length != data.size() || length > MAX_PAYLOAD) {
+                schedule(n, start, "+ERR=5\r\n");
+                return;
+            }
+
+            double airtime = lora_airtime_ms(params, length);
+            Clock::time_point done = after_ms(start, airtime);
+            node.busy_until = done;
+            stats.sent++;
+            stats.airtime_ms += airtime;
+            schedule(n, done, "+OK\r\n");
+
+            // 주소가 맞는 다른 node들로 전달 (주소 0 = broadcast), 손실은 수신 node마다 따로
+            std::string rcv = "+RCV=" + std::to_string(node.address) + "," + std::to_string(length) + "," + data + ",-40,10\r\n";
+            for (int peer = 0; peer < num_nodes; ++peer) {
+                if (peer == n || (dest != 0 && dest != nodes[peer].address)) continue;
+                if (uniform(rng) < loss) {
+                    stats.lost++;
+                    continue;
+                }
+                stats.delivered++;
+                schedule(peer, after_ms(done, latency_ms), rcv);
+            }
+        } else if (cmd.compare(0, 3, "AT+") == 0 && cmd.find('=') != std::string::npos) {
+            // AT+PARAMETER=, AT+BAND= 등 설정 명령은 받아들이기만 함
+            schedule(n, start, "+OK\r\n");
+        } else {
+            schedule(n, start, "+ERR=4\r\n");
+        }
+    };
+
+    char buf[512];
+    while (!g_stop) {
+        // C-1: 시각이 된 응답 write
+        Clock::time_point now = Clock::now();
+        while (!scheduled.empty() && scheduled.begin()->first <= now) {
+            const std::pair<int, std::string>& out = scheduled.begin()->second;
+            if (!write_all(nodes[out.first].master, out.second.data(), out.second.size())) {
+                std::cerr << "[Warning] node " << out.first << ": reply dropped (" << std::strerror(errno) << ")" << std::endl;
+            }
+            scheduled.erase(scheduled.begin());
+        }
+
+        // C-2: 다음 예약 시각까지 poll
+        int timeout_ms = 200;
+        if (!scheduled.empty()) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(scheduled.begin()->first - now).count();
+            timeout_ms = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(wait + 1, timeout_ms)));
+        }
+        std::vector<struct pollfd> pfds(num_nodes);
+        for (int n = 0; n < num_nodes; ++n) pfds[n] = { nodes[n].master, POLLIN, 0 };
+        if (poll(pfds.data(), pfds.size(), timeout_ms) <= 0) continue;
+
+        // C-3: 명령 읽기 (\r\n 단위)
+        for (int n = 0; n < num_nodes; ++n) {
+            if (!(pfds[n].revents & POLLIN)) continue;
+            ssize_t len = read(nodes[n].master, buf, sizeof(buf));
+            if (len <= 0) continue;
+            nodes[n].pending.append(buf, static_cast<size_t>(len));
+            size_t eol;
+            while ((eol = nodes[n].pending.find('\n')) != std::string::npos) {
+                std::string cmd = nodes[n].pending.substr(0, eol);
+                nodes[n].pending.erase(0, eol + 1);
+                if (!cmd.empty() && cmd.back() == '\r') cmd.pop_back();
+                if (!cmd.empty()) handle_command(n, cmd);
+            }
+        }
+    }
+
+    // ==========================================================
+    // D: Summary
+    // ==========================================================
+    std::cout << "\n--- Simulator summary ---" << std::endl;
+    std::cout << " Sent: " << stats.sent << ", delivered: " << stats.delivered << ", lost: " << stats.lost << std::endl;
+    std::cout << " Total airtime: " << stats.airtime_ms << " ms" << std::endl;
+    for (int n = 0; n < num_nodes; ++n) {
+        if (!link_prefix.empty()) unlink((link_prefix + std::to_string(n)).c_str());
+        close(nodes[n].slave);
+        close(nodes[n].master);
+    }
+    return 0;
+}
@@ -6,10 +6,12 @@
 #include <RaptorQ/RaptorQ_v1_hdr.hpp> // RaptorQ Library
 #include <cstdio>
 #include <cmath>
-#include <stdexcept>    // ⬅️ Base64 에러 처리를 위해 추가
 
 // ⬅️ Base64 디코딩을 위해 헤더 포함
 #include "base64.h"
+#include "Base64Simd.hpp"
+#include "FecBlocks.hpp"
+#include "TransferMeta.hpp"
 
 int main(int argc, char* argv[])
 {
@@ -48,52 +50,72 @@ int main(int argc, char* argv[])
     }
 
     std::string line; // Base64 문자열 한 줄
+    std::vector<uint8_t> received_packet(256); // 디코딩된 패킷 버퍼 (재사용, LoRa 최대 payload 이상)
     uint32_t received_count = 0;
+    uint32_t crc_failures = 0;     // CRC32C trailer 불일치로 버린 패킷 (손실로 처리)
     uint32_t line_number = 0;
     // Text File 한 줄씩 읽기
     while (std::getline(input_file, line)){
         line_number++;
         
-        try {
-            std::string decoded_str = base64_decode(line);
-            std::vector<uint8_t> received_packet(decoded_str.begin(), decoded_str.end());
-            
-            // --- C. [핵심] ID가 없는 패킷(32바이트)만 처리 ---
+        // Base64 검증 + 디코딩 (예외 없음, 손상된 줄도 정상 줄과 같은 비용)
+        Base64DecodeResult b64 = base64_decode_checked(line.data(), line.size(), received_packet.data(), received_packet.size());
+        size_t packet_len = b64.written;
+        if (b64.status == Base64Status::OUTPUT_TOO_SMALL) {
+            packet_len = base64_decoded_max_size(line.size());   // 너무 긴 패킷 -> 아래에서 크기 오류로 처리
+        } else if (b64.status != Base64Status::OK) {
+            std::cerr << "[Warning] Line " << line_number << ": Base64 decode failed at column " << (b64.error_offset + 1)
+                      << ". Packet corrupted." << std::endl;
+            continue;
+        }
+        
+        // --- C. [핵심] ID가 없는 패킷(32바이트)만 처리 ---
+        
+        // [변경] ID를 파일 줄 번호로 "가정" (ESI는 0부터 시작)
+        //  compact ID(1~3 bytes) 패킷이면 줄 번호 대신 실제 ESI 사용 (손실 / 순서 바뀜에도 안전)
+        //  ID가 있는 인코더 출력의 metadata record 줄은 건너뜀 (hash 확인은 ID 디코더에서)
+        TransferMeta meta;
+        if (parse_transfer_meta(received_packet.data(), packet_len, meta)) continue;
+        //  compact ID + CRC32C trailer 패킷은 CRC부터 확인 (불일치 = 손실)
+        if (check_packet_crc(received_packet.data(), packet_len, symbol_size) == PacketCheck::BAD) {
+            crc_failures++;
+            std::cerr << "[Warning] Line " << line_number << ": CRC32C mismatch. Treating packet as lost." << std::endl;
+            continue;
+        }
+        uint32_t assumed_symbol_id = line_number - 1;
+        uint8_t sbn = 0;
+        size_t id_len = 0;
+        if (packet_len > symbol_size && packet_len - symbol_size <= COMPACT_ID_MAX_SIZE) {
+            id_len = read_any_payload_id(received_packet.data(), packet_len, symbol_size, 0, sbn, assumed_symbol_id);
+        }
+
+        // 패킷 크기가 순수 심볼 32바이트인지 확인
+        if (packet_len == symbol_size || id_len > 0) {
             
-            // 패킷 크기가 순수 심볼 32바이트인지 확인
-            if (received_packet.size() == symbol_size) {
-                
-                // [변경] ID를 파일 줄 번호로 "가정" (ESI는 0부터 시작)
-                uint32_t assumed_symbol_id = line_number - 1;
-                
-                // [변경] 페이로드 시작 위치 = 패킷의 시작 (0번 인덱스)
-                auto payload_start = received_packet.begin();
-                
-                auto err = decoder.add_symbol(payload_start, received_packet.end(), assumed_symbol_id);
-
-                if (err == RaptorQ::Error::NONE){
-                    received_count++;
-                    // [변경] 로그 메시지 수정
-                    std::cout << " -> Added symbol with assumed ID: " << assumed_symbol_id << " (Total vaild: " << received_count << " )" << std::endl;
-                }else if (err != RaptorQ::Error::NOT_NEEDED) {
-                    std::cerr << "[Warning] Line " << line_number << ": Error adding symbol with assumed ID " << assumed_symbol_id << std::endl;
-                }
-            } 
-
-            // 그 외 (ID가 있거나(36) 손상된 패킷(기타), 무시)
-            else {
-                 // [변경] 기대하는 바이트 크기 수정
-                 std::cerr << "[Warning] Line " << line_number << ": Received packet with unexpected size (Size: " 
-                           << received_packet.size() << "). Expecting 32 bytes. Ignoring." << std::endl;
-            }
+            // [변경] 페이로드 시작 위치 = 패킷의 시작 (0번 인덱스, compact ID면 그 뒤)
+            auto payload_start = received_packet.begin() + id_len;
             
-            if (decoder.ready()) {
-                std::cout << ">>> Ready to decode after receiving " << received_count << " valid symbols." << std::endl;
-                break;
+            auto err = decoder.add_symbol(payload_start, received_packet.begin() + packet_len, assumed_symbol_id);
+
+            if (err == RaptorQ::Error::NONE){
+                received_count++;
+                // [변경] 로그 메시지 수정
+                std::cout << " -> Added symbol with assumed ID: " << assumed_symbol_id << " (Total vaild: " << received_count << " )" << std::endl;
+            }else if (err != RaptorQ::Error::NOT_NEEDED) {
+                std::cerr << "[Warning] Line " << line_number << ": Error adding symbol with assumed ID " << assumed_symbol_id << std::endl;
             }
+        } 
 
-        } catch (const std::exception& e) {
-            std::cerr << "[Warning] Line " << line_number << ": Base64 decode failed. Packet corrupted. (" << e.what() << ")" << std::endl;
+        // 그 외 (ID가 있거나(36) 손상된 패킷(기타), 무시)
+        else {
+             // [변경] 기대하는 바이트 크기 수정
+             std::cerr << "[Warning] Line " << line_number << ": Received packet with unexpected size (Size: " 
+                       << packet_len << "). Expecting 32 bytes. Ignoring." << std::endl;
+        }
+        
+        if (decoder.ready()) {
+            std::cout << ">>> Ready to decode after receiving " << received_count << " valid symbols." << std::endl;
+            break;
         }
     }
     input_file.close();
@@ -136,6 +158,7 @@ int main(int argc, char* argv[])
         std::cerr << "[FAILURE] Decode failed. Not enough valid symbols received." << std::endl;
         std::cerr << "  (Received " << received_count << " valid symbols, needed " << num_source_symbols << ")" << std::endl;
     }
+    if (crc_failures > 0) std::cout << "  CRC32C failures (dropped as erasures): " << crc_failures << std::endl;
 
     return 0;
 }
@@ -6,18 +6,39 @@
 #include <RaptorQ/RaptorQ_v1_hdr.hpp> // RaptorQ Library
 #include <cstdio>
 #include <cmath>
-#include <stdexcept>    // ⬅️ Base64 에러 처리를 위해 추가
+#include <algorithm>
 
 // ⬅️ Base64 디코딩을 위해 헤더 포함
 #include "base64.h"
+#include "Base64Simd.hpp"
+#include "FecBlocks.hpp"
+#include "PacketContainer.hpp"
+#include "Packetizer.hpp"
+#include "TransferMeta.hpp"
+#include "XxHash64.hpp"
 
 int main(int argc, char* argv[])
 {
     // Step1: Data Input
-    if (argc != 2){
-        std::cout << "[Error] 사용법 오류" << std::endl;
+    //  --framed: --mtu로 인코딩한 파일 (한 줄 = [n | ID] + n개의 심볼)
+    //  --size / --symbol-size: metadata record가 없는 (이전 인코더의) 파일용
+    if (argc < 2) {
+        std::cout << "[Error] 사용법 오류: ./FEC_decoder <input_file> [--framed] [--size BYTES] [--symbol-size N]" << std::endl;
         return 1;
     }
+    bool framed = false;
+    uint64_t size_option = 0;
+    uint16_t symbol_size_option = 0;
+    for (int i = 2; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (opt == "--framed") framed = true;
+        else if (opt == "--size" && i + 1 < argc) size_option = std::stoull(argv[++i]);
+        else if (opt == "--symbol-size" && i + 1 < argc) symbol_size_option = static_cast<uint16_t>(std::stoul(argv[++i]));
+        else {
+            std::cout << "[Error] 사용법 오류: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
 
     
     const std::string input_filename = argv[1];
@@ -26,81 +47,233 @@ int main(int argc, char* argv[])
     std::cout << "--- " << input_filename << " File Decoding---" << std::endl;
 
     // Step2: 메타데이터 설정
-    const uint16_t symbol_size = 32;
-    const uint32_t total_data_size = 660;
-    const uint32_t num_source_symbols = 26;
+    //  - .fecb 컨테이너: 헤더의 T, 원본 크기, K
+    //  - 텍스트 파일: metadata record(OTI)의 F, T, K (파일 안에 반복되므로 첫 줄이 손실돼도 됨)
+    //  - record가 없으면 --size (T는 --symbol-size, 기본 32)
+    uint16_t symbol_size = symbol_size_option > 0 ? symbol_size_option : 32;
+    uint64_t total_data_size = size_option;
+    uint32_t num_source_symbols = 0;
+    TransferMeta oti;
+
+    ContainerReader container;
+    const bool from_container = ContainerReader::isContainer(input_filename);
+    if (from_container) {
+        if (!container.open(input_filename)) {
+            std::cerr << "Error: Cannnot open input File " << input_filename << std::endl;
+            return 1;
+        }
+        if (container.header().num_blocks != 1) {
+            std::cerr << "[ERROR] Multi-block container (Z=" << container.header().num_blocks
+                      << ") is not supported here. Use decoder_image." << std::endl;
+            return 1;
+        }
+        symbol_size = container.header().symbol_size;
+        total_data_size = container.header().transfer_length;
+        num_source_symbols = container.header().num_source_symbols;
+    } else if (scan_transfer_meta(input_filename, oti)) {
+        total_data_size = oti.transfer_length;
+        if (oti.has_oti) {
+            if (oti.num_blocks != 1) {
+                std::cerr << "[ERROR] Multi-block transfer (Z=" << oti.num_blocks << ") is not supported here. Use decoder_image." << std::endl;
+                return 1;
+            }
+            symbol_size = oti.symbol_size;
+            num_source_symbols = oti.num_source_symbols;
+            std::cout << "Transfer ID " << oti.transfer_id << ": " << total_data_size << " bytes, symbol size " << symbol_size
+                      << ", K " << num_source_symbols << " (from metadata record)" << std::endl;
+        }
+    } else if (size_option == 0) {
+        std::cerr << "[ERROR] No transfer metadata record in " << input_filename << ". Pass --size BYTES (and --symbol-size N)." << std::endl;
+        return 1;
+    }
+
+    // 프레임 파일: OTI가 없으면 첫 번째 정상 프레임에서 T를 알아냄 (T = (길이 - 5) / n)
+    if (framed && !from_container && !oti.has_oti && symbol_size_option == 0) {
+        std::ifstream peek_file(input_filename);
+        std::string line;
+        std::vector<uint8_t> frame(256);
+        size_t frame_len = 0;
+        FrameView fv;
+        while (std::getline(peek_file, line)) {
+            if (base64_decode_to(line.data(), line.size(), frame.data(), frame.size(), frame_len) == Base64Status::OK &&
+                parse_frame(frame.data(), frame_len, fv)) {
+                symbol_size = fv.symbol_size;
+                break;
+            }
+        }
+        std::cout << "Framed input, symbol size: " << symbol_size << " bytes" << std::endl;
+    }
+    // K가 없으면 (record 없음 / version 1) 인코더와 같은 방식으로 계산
+    if (num_source_symbols == 0) {
+        num_source_symbols = static_cast<uint32_t>(select_block_size(static_cast<uint32_t>((total_data_size + symbol_size - 1) / symbol_size)));
+    }
+    if (total_data_size == 0 || num_source_symbols == 0) {
+        std::cerr << "[ERROR] Invalid transfer parameters (size " << total_data_size << ", symbol size " << symbol_size << ")" << std::endl;
+        return 1;
+    }
 
     // Step3: Decoder 설정
     namespace RaptorQ = RaptorQ__v1;
     using namespace RaptorQ;
-    using InputIt = std::vector<uint8_t>::iterator;
+    using InputIt = const uint8_t*;     // 패킷 버퍼 / mmap 레코드를 직접 가리킴
     using OutputIt = std::vector<uint8_t>::iterator;
     using Decoder = RaptorQ::Decoder<InputIt,OutputIt>;
 
     Block_Size block = static_cast<Block_Size>(num_source_symbols);
     Decoder decoder(block, symbol_size, Decoder::Report::COMPLETE);
 
-    std::ifstream input_file(input_filename);
-    if(!input_file){
-        std::cerr << "Error: Cannnot open input File " << input_filename << std::endl;
-        return 1; 
-    }
-
-    std::string line; // Base64 문자열 한 줄
     uint32_t received_count = 0;
-    uint32_t line_number = 0;
-    // Text File 한 줄씩 읽기
-    while (std::getline(input_file, line)){
-        line_number++;
-        
-        try {
-            std::string decoded_str = base64_decode(line);
-            std::vector<uint8_t> received_packet(decoded_str.begin(), decoded_str.end());
-            
-            // --- C. [핵심] ID가 있는 패킷(36바이트)만 처리 ---
-            
-            // 패킷 크기가 (ID 4바이트 + 심볼 32바이트) = 36바이트인지 확인
-            if (received_packet.size() == (4 + symbol_size)) {
-                
-                // ID 4바이트 추출
-                uint32_t symbol_id = (static_cast<uint32_t>(received_packet[0]) << 24) |
-                                     (static_cast<uint32_t>(received_packet[1]) << 16) |
-                                     (static_cast<uint32_t>(received_packet[2]) << 8)  |
-                                     (static_cast<uint32_t>(received_packet[3]));
-                
-                // 페이로드(순수 심볼 데이터) 32바이트의 시작 위치
-                auto payload_start = received_packet.begin() + 4;
-                
-                auto err = decoder.add_symbol(payload_start, received_packet.end(), symbol_id);
-
-                if (err == RaptorQ::Error::NONE){
-                    received_count++;
-                    std::cout << " -> Added symbol ID: " << symbol_id << " (Total vaild: " << received_count << " )" << std::endl;
-                }else if (err != RaptorQ::Error::NOT_NEEDED) {
-                    std::cerr << "[Warning] Line " << line_number << ": Error adding symbol ID " << symbol_id << std::endl;
-                }
-            } 
-
-            // 그 외 (ID가 없거나(32) 손상된 패킷(기타), 무시)
-            else {
-                 std::cerr << "[Warning] Line " << line_number << ": Received packet with unexpected size (Size: " 
-                           << received_packet.size() << "). Expecting 36 bytes. Ignoring." << std::endl;
+    uint32_t crc_failures = 0;     // CRC32C trailer 불일치로 버린 패킷 (손실로 처리)
+
+    // Systematic fast path: 데이터가 들어 있는 source symbol(ID < ceil(F/T))은 도착 즉시 제자리에 복사
+    //  -> 모두 도착하면 wait_sync() / decode_bytes() 없이 완료 (repair가 필요할 때만 행렬 디코딩)
+    const uint32_t data_symbols = static_cast<uint32_t>((total_data_size + symbol_size - 1) / symbol_size);
+    std::vector<uint8_t> decoded_data(total_data_size);
+    std::vector<bool> source_present(data_symbols, false);
+    uint32_t source_count = 0;
+
+    // 심볼 한 개를 decoder에 추가 (패킷/프레임/컨테이너 공용), ready가 되면 true
+    auto add_symbol = [&](uint32_t symbol_id, const uint8_t* payload_start, const char* unit, uint32_t number) {
+        if (symbol_id < data_symbols && !source_present[symbol_id]) {
+            size_t offset = static_cast<size_t>(symbol_id) * symbol_size;
+            size_t len = std::min<size_t>(symbol_size, total_data_size - offset);
+            std::copy(payload_start, payload_start + len, decoded_data.begin() + offset);
+            source_present[symbol_id] = true;
+            if (++source_count == data_symbols) {
+                received_count++;
+                std::cout << " -> Added symbol ID: " << symbol_id << " (all source symbols present)" << std::endl;
+                return true;
             }
-            
-            if (decoder.ready()) {
-                std::cout << ">>> Ready to decode after receiving " << received_count << " valid symbols." << std::endl;
-                break;
+        }
+
+        auto err = decoder.add_symbol(payload_start, payload_start + symbol_size, symbol_id);
+
+        if (err == RaptorQ::Error::NONE){
+            received_count++;
+            std::cout << " -> Added symbol ID: " << symbol_id << " (Total vaild: " << received_count << " )" << std::endl;
+        }else if (err != RaptorQ::Error::NOT_NEEDED) {
+            std::cerr << "[Warning] " << unit << " " << number << ": Error adding symbol ID " << symbol_id << std::endl;
+        }
+        return decoder.ready();
+    };
+
+    // Transfer metadata record (원본 xxHash64): 저장 전에 복원 결과와 비교, v2 컨테이너는 헤더에 있음
+    bool has_hash = from_container && container.header().has_hash;
+    uint64_t expected_hash = has_hash ? container.header().content_hash : 0;
+    auto take_meta = [&](const uint8_t* packet, size_t packet_len) {
+        TransferMeta meta;
+        if (!parse_transfer_meta(packet, packet_len, meta)) return false;
+        bool same = meta.transfer_length == total_data_size &&
+                    (!meta.has_oti || (meta.symbol_size == symbol_size && (!oti.has_oti || meta.transfer_id == oti.transfer_id)));
+        if (!same) {
+            std::cerr << "[Warning] Metadata for another transfer (" << meta.transfer_length << " bytes, expected "
+                      << total_data_size << "). Ignoring." << std::endl;
+        } else if (meta.has_hash) {
+            has_hash = true;
+            expected_hash = meta.content_hash;
+        }
+        return true;
+    };
+
+    // ID(4바이트) + 심볼 한 개
+    auto add_packet = [&](const uint8_t* packet, size_t packet_len, const char* unit, uint32_t number) {
+        // --- C. [핵심] ID가 있는 패킷(4 + T 바이트, compact ID면 1~3 + T 바이트)만 처리 ---
+        // 그 외 (ID가 없거나(32) 손상된 패킷(기타), 무시)
+        // CRC32C trailer가 있으면 먼저 확인 (Base64는 통과했지만 bit가 바뀐 패킷 = 손실)
+        if (check_packet_crc(packet, packet_len, symbol_size) == PacketCheck::BAD) {
+            crc_failures++;
+            std::cerr << "[Warning] " << unit << " " << number << ": CRC32C mismatch. Treating packet as lost." << std::endl;
+            return false;
+        }
+        uint8_t sbn = 0;
+        uint32_t symbol_id = 0;
+        size_t id_len = read_any_payload_id(packet, packet_len, symbol_size, 0, sbn, symbol_id);
+        if (id_len == 0 || sbn != 0) {
+            std::cerr << "[Warning] " << unit << " " << number << ": Received packet with unexpected size (Size: "
+                      << packet_len << "). Expecting " << (1 + symbol_size) << "~" << (PAYLOAD_ID_SIZE + PACKET_CRC_SIZE + symbol_size) << " bytes. Ignoring." << std::endl;
+            return false;
+        }
+
+        // 페이로드(순수 심볼 데이터)의 시작 위치
+        return add_symbol(symbol_id, packet + id_len, unit, number);
+    };
+
+    // [n | ID] + n개의 심볼 (ID는 첫 심볼, 이후 연속)
+    auto add_frame = [&](const uint8_t* frame, size_t frame_len, const char* unit, uint32_t number) {
+        FrameView fv;
+        if (!parse_frame(frame, frame_len, fv) || fv.symbol_size != symbol_size || fv.sbn != 0) {
+            std::cerr << "[Warning] " << unit << " " << number << ": Malformed frame (Size: " << frame_len << "). Ignoring." << std::endl;
+            return false;
+        }
+        for (uint8_t i = 0; i < fv.count; ++i) {
+            if (add_symbol(fv.first_esi + i, fv.symbols + i * symbol_size, unit, number)) return true;
+        }
+        return false;
+    };
+
+    if (from_container) {
+        // 컨테이너: mmap 레코드를 복사 없이 바로 decoder에 넘김
+        for (size_t i = 0; i < container.size(); ++i) {
+            if (add_packet(container.record(i), container.recordSize(), "Record", static_cast<uint32_t>(i + 1))) break;
+        }
+        container.close();
+    } else {
+        std::ifstream input_file(input_filename);
+        if(!input_file){
+            std::cerr << "Error: Cannnot open input File " << input_filename << std::endl;
+            return 1;
+        }
+
+        std::string line; // Base64 문자열 한 줄
+        std::vector<uint8_t> received_packet(256); // 디코딩된 패킷 버퍼 (재사용, LoRa 최대 payload 이상)
+        uint32_t line_number = 0;
+        // Text File 한 줄씩 읽기
+        while (std::getline(input_file, line)){
+            line_number++;
+
+            // Base64 검증 + 디코딩 (예외 없음, 손상된 줄도 정상 줄과 같은 비용)
+            Base64DecodeResult b64 = base64_decode_checked(line.data(), line.size(), received_packet.data(), received_packet.size());
+            size_t packet_len = b64.written;
+            if (b64.status == Base64Status::OUTPUT_TOO_SMALL) {
+                packet_len = base64_decoded_max_size(line.size());   // 너무 긴 패킷 -> 크기 오류로 처리
+            } else if (b64.status != Base64Status::OK) {
+                std::cerr << "[Warning] Line " << line_number << ": Base64 decode failed at column " << (b64.error_offset + 1)
+                          << ". Packet corrupted." << std::endl;
+                continue;
             }
 
-        } catch (const std::exception& e) {
-            std::cerr << "[Warning] Line " << line_number << ": Base64 decode failed. Packet corrupted. (" << e.what() << ")" << std::endl;
+            if (take_meta(received_packet.data(), packet_len)) continue;
+            bool done = framed ? add_frame(received_packet.data(), packet_len, "Line", line_number)
+                               : add_packet(received_packet.data(), packet_len, "Line", line_number);
+            if (done) break;
+        }
+        input_file.close();
+    }
+    // 복원 결과 저장 (metadata의 hash와 다르면 틀린 파일을 만들지 않음)
+    auto save_output = [&]() {
+        if (has_hash && xxh64(decoded_data.data(), decoded_data.size()) != expected_hash) {
+            std::cerr << "[FAILURE] Content hash mismatch. Restored data differs from the source, not saving " << output_filename << std::endl;
+            return false;
         }
+        std::ofstream out_file(output_filename);
+        out_file.write(reinterpret_cast<const char*>(decoded_data.data()), decoded_data.size());
+        out_file.close();
+        if (has_hash) std::cout << "  Content hash verified (xxHash64)" << std::endl;
+        return true;
+    };
+
+    const bool source_complete = (source_count == data_symbols);
+    if (source_complete || decoder.ready()) {
+        std::cout << ">>> Ready to decode after receiving " << received_count << " valid symbols." << std::endl;
     }
-    input_file.close();
 
-    if (decoder.ready()){
+    if (source_complete) {
+        // 손실 없는 source symbol만으로 복원 완료 -> 행렬 디코딩 생략
+        if (save_output()) {
+            std::cout << "[SUCCESS] Decode complete (source symbols only, no matrix decoding)! Restored data saved to " << output_filename << std::endl;
+        }
+    } else if (decoder.ready()){
         std::cout << "Decoding... " <<std::endl;
-        std::vector<uint8_t> decoded_data(total_data_size);
         auto out_it = decoded_data.begin();
         
         // 더 이상 입력이 없음을 알림
@@ -122,11 +295,7 @@ int main(int argc, char* argv[])
             
             if (decoded.written == total_data_size) {
                 // Success
-                std::ofstream out_file(output_filename);
-                out_file.write(reinterpret_cast<const char*>(decoded_data.data()), decoded_data.size());
-                out_file.close();
-
-                std::cout << "[SUCCESS] Decode complete! Restored data saved to " << output_filename << std::endl;
+                if (save_output()) std::cout << "[SUCCESS] Decode complete! Restored data saved to " << output_filename << std::endl;
             } else {
                 std::cerr << "[FAILURE] Decode failed. Wrote " << decoded.written << " bytes, expected " << total_data_size << std::endl;
             }
@@ -135,6 +304,7 @@ int main(int argc, char* argv[])
         std::cerr << "[FAILURE] Decode failed. Not enough valid symbols received." << std::endl;
         std::cerr << "  (Received " << received_count << " valid symbols, needed " << num_source_symbols << ")" << std::endl;
     }
+    if (crc_failures > 0) std::cout << "  CRC32C failures (dropped as erasures): " << crc_failures << std::endl;
 
     return 0;
 }